@@ -2,39 +2,91 @@
 
 #include <sstream>
 
+namespace
+{
+	// in ActionId order
+	const char* const ActionNames[] =
+	{
+		"NONE",
+		"UP",
+		"DOWN",
+		"LEFT",
+		"RIGHT",
+		"PLAY",
+		"QUIT",
+		"PAUSE",
+		"SPEED_NORMAL",
+		"SPEED_FAST",
+		"SPEED_SUPERFAST",
+		"SPEED_ULTRA",
+		"TOGGLE_TEXTURE",
+		"TOGGLE_COLLISION",
+		"TOGGLE_GRID",
+		"ROTATE_CLOCKWISE",
+		"ROTATE_COUNTERCLOCKWISE",
+		"LEFT_CLICK",
+		"MIDDLE_CLICK",
+		"RIGHT_CLICK",
+		"MOUSE_MOVE"
+	};
+	static_assert(sizeof(ActionNames) / sizeof(ActionNames[0]) == (size_t)ActionId::Count, "every action needs a name");
+
+	const char* const ActionTypeNames[] = { "NONE", "START", "END" };
+	static_assert(sizeof(ActionTypeNames) / sizeof(ActionTypeNames[0]) == (size_t)ActionType::Count, "every action type needs a name");
+}
+
+const char* actionName(ActionId id)
+{
+	return (size_t)id < (size_t)ActionId::Count ? ActionNames[(size_t)id] : ActionNames[0];
+}
+
+ActionId actionId(const std::string& name)
+{
+	for (size_t i = 0; i < (size_t)ActionId::Count; ++i)
+	{
+		if (name == ActionNames[i]) { return (ActionId)i; }
+	}
+	return ActionId::None;
+}
+
+const char* actionTypeName(ActionType type)
+{
+	return (size_t)type < (size_t)ActionType::Count ? ActionTypeNames[(size_t)type] : ActionTypeNames[0];
+}
+
 Action::Action()
 {
 
 }
 
-Action::Action(const std::string& name, const std::string& type)
-	: m_name(name)
+Action::Action(ActionId id, ActionType type)
+	: m_id(id)
 	, m_type(type)
 {
 
 }
 
-Action::Action(const std::string& name, Vec2 pos)
-	: m_name(name)
+Action::Action(ActionId id, Vec2 pos)
+	: m_id(id)
 	, m_pos(pos)
 {
 
 }
 
-Action::Action(const std::string& name, const std::string& type, Vec2 pos)
-	: m_name(name)
+Action::Action(ActionId id, ActionType type, Vec2 pos)
+	: m_id(id)
 	, m_type(type)
 	, m_pos(pos)
 {
 
 }
 
-const std::string& Action::name() const
+ActionId Action::id() const
 {
-	return m_name;
+	return m_id;
 }
 
-const std::string& Action::type() const
+ActionType Action::type() const
 {
 	return m_type;
 }
@@ -47,6 +99,6 @@ const Vec2& Action::pos() const
 std::string Action::toString() const
 {
 	std::stringstream ss;
-	ss << name() << " " << type() << " " << (int)m_pos.x << " " << (int)m_pos.y;
+	ss << actionName(m_id) << " " << actionTypeName(m_type) << " " << (int)m_pos.x << " " << (int)m_pos.y;
 	return ss.str();
 }
@@ -2,22 +2,65 @@
 
 #include "Vec2.h"
 #include <string>
+#include <cstdint>
+
+// Every action a scene can bind input to. Actions are interned as these ids rather than carried around
+// as strings, so making one allocates nothing and scenes dispatch them with a switch. The names are only
+// used to print an action or to read one back.
+enum class ActionId : uint8_t
+{
+	None,
+	Up,
+	Down,
+	Left,
+	Right,
+	Play,
+	Quit,
+	Pause,
+	SpeedNormal,
+	SpeedFast,
+	SpeedSuperfast,
+	SpeedUltra,
+	ToggleTexture,
+	ToggleCollision,
+	ToggleGrid,
+	RotateClockwise,
+	RotateCounterclockwise,
+	LeftClick,
+	MiddleClick,
+	RightClick,
+	MouseMove,
+	Count
+};
+
+enum class ActionType : uint8_t
+{
+	None,
+	Start,
+	End,
+	Count
+};
+
+// "UP", "LEFT_CLICK", ... and back. An unknown name is ActionId::None.
+const char* actionName(ActionId id);
+ActionId actionId(const std::string& name);
+const char* actionTypeName(ActionType type);
 
 class Action
 {
-	std::string m_name = "NONE";
-	std::string m_type = "NONE";
-	Vec2		m_pos = Vec2(0, 0);
+	ActionId   m_id = ActionId::None;
+	ActionType m_type = ActionType::None;
+	Vec2	   m_pos = Vec2(0, 0);
 
 public:
 
 	Action();
-	Action(const std::string& name, const std::string& type);
-	Action(const std::string& name, Vec2 pos);
-	Action(const std::string& name, const std::string& type, Vec2 pos);
+	Action(ActionId id, ActionType type);
+	Action(ActionId id, Vec2 pos);
+	Action(ActionId id, ActionType type, Vec2 pos);
 
-	const std::string& name() const;
-	const std::string& type() const;
+	ActionId id() const;
+	ActionType type() const;
 	const Vec2& pos() const;
 	std::string toString() const;
 };
\ No newline at end of file
@@ -1,5 +1,4 @@
 #include "Animation.h"
-#include <cmath>
 
 Animation::Animation()
 {
@@ -13,27 +12,48 @@ Animation::Animation(const std::string& name, const sf::Texture& t)
 }
 
 Animation::Animation(const std::string& name, const sf::Texture& t, size_t frameCount, size_t speed)
-	: m_name        (name)
-	, m_sprite      (t)
-	, m_frameCount  (frameCount)
-	, m_currentFrame(0)
+	: Animation(name, t, sf::IntRect(0, 0, (int)t.getSize().x, (int)t.getSize().y), frameCount, speed)
+{
+
+}
+
+Animation::Animation(const std::string& name, const sf::Texture& t, const sf::IntRect& region, size_t frameCount, size_t speed)
+	: m_texture     (&t)
+	, m_frameCount  (frameCount > 0 ? frameCount : 1)	// a clip always has at least the one frame it shows
 	, m_speed       (speed)
+	, m_region      (region)
+	, m_name        (name)
 {
-	m_size = Vec2((float)t.getSize().x / frameCount, (float)t.getSize().y);
-	m_sprite.setOrigin(m_size.x / 2.0f, m_size.y / 2.0f);
-	m_sprite.setTextureRect(sf::IntRect((int)std::floor(m_currentFrame) * (int)m_size.x, 0, (int)m_size.x, (int)m_size.y));
+	m_size = Vec2((float)region.width / m_frameCount, (float)region.height);
+	m_radius = m_size.length() / 2.0f;
 }
 
-void Animation::update()
+size_t Animation::frameAt(size_t gameFrames, bool repeat) const
 {
 	// If the speed is zero then there is only one animation frame and no other frames to switch to.
-	if (m_speed != 0)
-	{
-		m_currentFrame++;
-		size_t animFrame = (m_currentFrame / m_speed) % m_frameCount;
+	if (m_speed == 0) { return 0; }
+	if (!repeat && hasEnded(gameFrames)) { return m_frameCount - 1; }
+	return (gameFrames / m_speed) % m_frameCount;
+}
 
-		m_sprite.setTextureRect(sf::IntRect((int)std::floor(animFrame) * (int)m_size.x, 0, (int)m_size.x, (int)m_size.y));
-	}
+bool Animation::hasEnded(size_t gameFrames) const
+{
+	return gameFrames >= m_frameCount * m_speed;
+}
+
+sf::IntRect Animation::frameRect(size_t frame) const
+{
+	return sf::IntRect(m_region.left + (int)frame * (int)m_size.x, m_region.top, (int)m_size.x, (int)m_size.y);
+}
+
+bool Animation::applyFrame(sf::Sprite& sprite, size_t frame) const
+{
+	if (!m_texture) { return false; }
+
+	sprite.setTexture(*m_texture);
+	sprite.setTextureRect(frameRect(frame));
+	sprite.setOrigin(m_size.x / 2.0f, m_size.y / 2.0f);
+	return true;
 }
 
 const Vec2& Animation::getSize() const
@@ -41,27 +61,27 @@ const Vec2& Animation::getSize() const
 	return m_size;
 }
 
+float Animation::getRadius() const
+{
+	return m_radius;
+}
+
 const std::string& Animation::getName() const
 {
 	return m_name;
 }
 
-sf::Sprite& Animation::getSprite()
+const sf::Texture* Animation::getTexture() const
 {
-	return m_sprite;
+	return m_texture;
 }
 
-const sf::Sprite& Animation::getSprite() const
+size_t Animation::getFrameCount() const
 {
-	return m_sprite;
+	return m_frameCount;
 }
 
-bool Animation::hasEnded() const
+size_t Animation::getSpeed() const
 {
-	if (m_currentFrame == m_frameCount * m_speed)
-	{
-		return true;
-	}
-	return false;
-
+	return m_speed;
 }
\ No newline at end of file
@@ -5,26 +5,39 @@
 #include <vector>
 #include <SFML/Graphics.hpp>
 
+// A clip: the frames of an animation and how fast they play. Clips are made by Assets when loading and
+// never change, every entity playing one shares it and only keeps its id and when it started playing
+// (CAnimation). Sprites are made from a clip when something is drawn.
 class Animation
 {
-	sf::Sprite  m_sprite;
-	size_t	    m_frameCount   = 1;  // total number of frames of animation
-	size_t	    m_currentFrame = 0;  // the current frame of animation being played
-	size_t		m_gameFrame	   = 0;  // the game frame this animation was created on
-	size_t      m_speed		   = 0;  // the speed or duration to play this animation
-	Vec2	    m_size		   = { 1, 1 };  // size of the animation frame
-	std::string m_name         = "none";
+	const sf::Texture* m_texture	  = nullptr;
+	size_t			   m_frameCount   = 1;  // total number of frames of animation
+	size_t			   m_speed		  = 0;  // game frames each animation frame is shown for, 0 for a still image
+	Vec2			   m_size		  = { 1, 1 };  // size of the animation frame
+	float			   m_radius		  = 0;         // half the frame's diagonal, how far it reaches from its middle at any rotation
+	sf::IntRect		   m_region;                   // the part of the texture the frames are in, side by side
+	std::string		   m_name         = "none";
 
 public:
 
 	Animation();
 	Animation(const std::string& name, const sf::Texture& t);
 	Animation(const std::string& name, const sf::Texture& t, size_t frameCount, size_t speed);
+	Animation(const std::string& name, const sf::Texture& t, const sf::IntRect& region, size_t frameCount, size_t speed);
+
+	// the frame shown after the animation has been playing for the given number of game frames
+	size_t frameAt(size_t gameFrames, bool repeat) const;
+	bool hasEnded(size_t gameFrames) const;
+	sf::IntRect frameRect(size_t frame) const;
+
+	// Points sprite at a frame of this animation with its origin in the middle of the frame. Returns false
+	// and leaves the sprite alone if there is no texture to show, as for the empty "none" animation.
+	bool applyFrame(sf::Sprite& sprite, size_t frame) const;
 
-	void update();
-	bool hasEnded() const;
 	const std::string& getName() const;
 	const Vec2& getSize() const;
-	sf::Sprite& getSprite();
-	const sf::Sprite& getSprite() const;
+	float getRadius() const;
+	const sf::Texture* getTexture() const;
+	size_t getFrameCount() const;
+	size_t getSpeed() const;
 };
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+// A handle to an asset: its index in the array Assets keeps that kind of asset in. Names are turned into
+// handles once, when a level or the asset file is read, and everything after that indexes the arrays.
+// The tag only keeps one kind of handle from being passed where another is expected.
+template <typename Tag>
+struct AssetId
+{
+	static constexpr uint32_t invalidIndex = UINT32_MAX;
+
+	uint32_t index = invalidIndex;
+
+	bool isValid() const { return index != invalidIndex; }
+	bool operator == (const AssetId& rhs) const { return index == rhs.index; }
+	bool operator != (const AssetId& rhs) const { return !(*this == rhs); }
+};
+
+typedef AssetId<struct TextureTag>   TextureId;
+typedef AssetId<struct AnimationTag> AnimationId;
+typedef AssetId<struct FontTag>      FontId;
+typedef AssetId<struct SoundTag>     SoundId;
\ No newline at end of file
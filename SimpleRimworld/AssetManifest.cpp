@@ -0,0 +1,287 @@
+#include "AssetManifest.h"
+#include "MemoryMapping.h"
+
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+namespace
+{
+	const char Magic[4] = { 'S', 'R', 'A', 'M' };
+
+	struct Header
+	{
+		char     magic[4];
+		uint32_t version;
+		uint64_t sourceHash;
+		uint32_t textureCount;
+		uint32_t fontCount;
+		uint32_t soundCount;
+		uint32_t musicCount;
+		uint32_t tilesheetCount;
+		uint32_t tileNameCount;
+		uint32_t tileCount;
+		uint32_t animationCount;
+		uint32_t stringBytes;
+		uint32_t padding;
+	};
+
+	struct FileRecord
+	{
+		uint32_t name;
+		uint32_t path;
+	};
+
+	struct TilesheetRecord
+	{
+		uint32_t name;
+		uint32_t path;
+		uint32_t firstTileName;
+		uint32_t tileNameCount;
+		uint32_t firstTile;
+		uint32_t tileCount;
+		uint32_t sliced;
+		uint32_t padding;
+		uint64_t contentHash;
+		uint64_t fileSize;
+		int64_t  writeTime;
+	};
+
+	struct TileRecord
+	{
+		int32_t left, top, width, height;
+	};
+
+	struct AnimationRecord
+	{
+		uint32_t name;
+		uint32_t textureName;
+		uint32_t frameCount;
+		uint32_t speed;
+	};
+
+	// Sections are written in this order. The 8 byte aligned ones come first so every record is aligned
+	// when the file is mapped.
+	static_assert(sizeof(Header) % 8 == 0 && sizeof(TilesheetRecord) % 8 == 0, "manifest records must stay 8 byte aligned");
+
+	// interns every name and path so each is stored once
+	class StringTable
+	{
+		std::unordered_map<std::string, uint32_t> m_offsets;
+		std::string                               m_bytes;
+
+	public:
+
+		uint32_t add(const std::string& text)
+		{
+			auto it = m_offsets.find(text);
+			if (it != m_offsets.end()) { return it->second; }
+
+			uint32_t offset = (uint32_t)m_bytes.size();
+			m_bytes.append(text.c_str(), text.size() + 1);
+			m_offsets[text] = offset;
+			return offset;
+		}
+
+		const std::string& bytes() const { return m_bytes; }
+	};
+
+	template <typename T>
+	void writeRecords(std::ofstream& file, const std::vector<T>& records)
+	{
+		file.write((const char*)records.data(), records.size() * sizeof(T));
+	}
+}
+
+void AssetManifest::fileStamp(const std::string& path, uint64_t& size, int64_t& writeTime)
+{
+	std::error_code error;
+	size = (uint64_t)std::filesystem::file_size(path, error);
+	if (error) { size = 0; }
+	auto time = std::filesystem::last_write_time(path, error);
+	writeTime = error ? 0 : (int64_t)time.time_since_epoch().count();
+}
+
+bool AssetManifest::write(const std::string& path, uint64_t sourceHash, const AssetList& list)
+{
+	StringTable strings;
+	auto fileRecords = [&](const std::vector<AssetList::File>& files)
+	{
+		std::vector<FileRecord> records;
+		for (const AssetList::File& file : files) { records.push_back({ strings.add(file.name), strings.add(file.path) }); }
+		return records;
+	};
+
+	std::vector<FileRecord> textures = fileRecords(list.textures);
+	std::vector<FileRecord> fonts = fileRecords(list.fonts);
+	std::vector<FileRecord> sounds = fileRecords(list.sounds);
+	std::vector<FileRecord> music = fileRecords(list.music);
+
+	std::vector<TilesheetRecord> tilesheets;
+	std::vector<uint32_t> tileNames;
+	std::vector<TileRecord> tiles;
+	for (const AssetList::Tilesheet& sheet : list.tilesheets)
+	{
+		TilesheetRecord record = {};
+		record.name = strings.add(sheet.name);
+		record.path = strings.add(sheet.path);
+		record.firstTileName = (uint32_t)tileNames.size();
+		record.tileNameCount = (uint32_t)sheet.tileNames.size();
+		record.firstTile = (uint32_t)tiles.size();
+		record.tileCount = sheet.sliced ? (uint32_t)sheet.tiles.size() : 0;
+		record.sliced = sheet.sliced ? 1 : 0;
+		record.contentHash = sheet.contentHash;
+		record.fileSize = sheet.fileSize;
+		record.writeTime = sheet.writeTime;
+		tilesheets.push_back(record);
+
+		for (const std::string& name : sheet.tileNames) { tileNames.push_back(strings.add(name)); }
+		if (sheet.sliced)
+		{
+			for (const sf::IntRect& tile : sheet.tiles) { tiles.push_back({ tile.left, tile.top, tile.width, tile.height }); }
+		}
+	}
+
+	std::vector<AnimationRecord> animations;
+	for (const AssetList::Animation& animation : list.animations)
+	{
+		animations.push_back({ strings.add(animation.name), strings.add(animation.textureName), animation.frameCount, animation.speed });
+	}
+
+	Header header = {};
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.sourceHash = sourceHash;
+	header.textureCount = (uint32_t)textures.size();
+	header.fontCount = (uint32_t)fonts.size();
+	header.soundCount = (uint32_t)sounds.size();
+	header.musicCount = (uint32_t)music.size();
+	header.tilesheetCount = (uint32_t)tilesheets.size();
+	header.tileNameCount = (uint32_t)tileNames.size();
+	header.tileCount = (uint32_t)tiles.size();
+	header.animationCount = (uint32_t)animations.size();
+	header.stringBytes = (uint32_t)strings.bytes().size();
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file) { return false; }
+	file.write((const char*)&header, sizeof(header));
+	writeRecords(file, tilesheets);
+	writeRecords(file, textures);
+	writeRecords(file, fonts);
+	writeRecords(file, sounds);
+	writeRecords(file, music);
+	writeRecords(file, tileNames);
+	writeRecords(file, tiles);
+	writeRecords(file, animations);
+	file.write(strings.bytes().data(), strings.bytes().size());
+	return file.good();
+}
+
+bool AssetManifest::read(const std::string& path, uint64_t sourceHash, AssetList& list)
+{
+	if (!std::filesystem::exists(path)) { return false; }
+
+	MemoryMapping mm(path);
+	const char* data = mm.getData();
+	size_t size = mm.getSize();
+	if (!data || size < sizeof(Header))
+	{
+		mm.close();
+		return false;
+	}
+
+	const Header& header = *(const Header*)data;
+	size_t expectedSize = sizeof(Header) + header.tilesheetCount * sizeof(TilesheetRecord)
+		+ ((size_t)header.textureCount + header.fontCount + header.soundCount + header.musicCount) * sizeof(FileRecord)
+		+ header.tileNameCount * sizeof(uint32_t) + header.tileCount * sizeof(TileRecord)
+		+ header.animationCount * sizeof(AnimationRecord) + header.stringBytes;
+	if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version || header.sourceHash != sourceHash ||
+		expectedSize != size || header.stringBytes == 0 || data[size - 1] != '\0')
+	{
+		mm.close();
+		return false;
+	}
+
+	// the records are used straight out of the mapping, only the strings are copied out
+	const char* cursor = data + sizeof(Header);
+	auto section = [&cursor](size_t count, size_t recordSize)
+	{
+		const char* start = cursor;
+		cursor += count * recordSize;
+		return start;
+	};
+	const TilesheetRecord* tilesheets = (const TilesheetRecord*)section(header.tilesheetCount, sizeof(TilesheetRecord));
+	const FileRecord* textures = (const FileRecord*)section(header.textureCount, sizeof(FileRecord));
+	const FileRecord* fonts = (const FileRecord*)section(header.fontCount, sizeof(FileRecord));
+	const FileRecord* sounds = (const FileRecord*)section(header.soundCount, sizeof(FileRecord));
+	const FileRecord* music = (const FileRecord*)section(header.musicCount, sizeof(FileRecord));
+	const uint32_t* tileNames = (const uint32_t*)section(header.tileNameCount, sizeof(uint32_t));
+	const TileRecord* tiles = (const TileRecord*)section(header.tileCount, sizeof(TileRecord));
+	const AnimationRecord* animations = (const AnimationRecord*)section(header.animationCount, sizeof(AnimationRecord));
+	const char* strings = cursor;
+
+	// an offset past the table would read outside the file
+	bool valid = true;
+	auto string = [&](uint32_t offset)
+	{
+		if (offset >= header.stringBytes) { valid = false; return std::string(); }
+		return std::string(strings + offset);
+	};
+	auto files = [&](const FileRecord* records, uint32_t count, std::vector<AssetList::File>& out)
+	{
+		out.clear();
+		for (uint32_t i = 0; i < count; ++i) { out.push_back({ string(records[i].name), string(records[i].path) }); }
+	};
+
+	AssetList read;
+	files(textures, header.textureCount, read.textures);
+	files(fonts, header.fontCount, read.fonts);
+	files(sounds, header.soundCount, read.sounds);
+	files(music, header.musicCount, read.music);
+
+	for (uint32_t i = 0; i < header.tilesheetCount; ++i)
+	{
+		const TilesheetRecord& record = tilesheets[i];
+		if ((uint64_t)record.firstTileName + record.tileNameCount > header.tileNameCount ||
+			(uint64_t)record.firstTile + record.tileCount > header.tileCount)
+		{
+			valid = false;
+			break;
+		}
+
+		AssetList::Tilesheet sheet;
+		sheet.name = string(record.name);
+		sheet.path = string(record.path);
+		for (uint32_t t = 0; t < record.tileNameCount; ++t) { sheet.tileNames.push_back(string(tileNames[record.firstTileName + t])); }
+
+		// an image that has been touched since is hashed and sliced again
+		uint64_t fileSize = 0;
+		int64_t writeTime = 0;
+		fileStamp(sheet.path, fileSize, writeTime);
+		if (fileSize == record.fileSize && writeTime == record.writeTime)
+		{
+			sheet.sliced = record.sliced != 0;
+			sheet.contentHash = record.contentHash;
+			sheet.fileSize = record.fileSize;
+			sheet.writeTime = record.writeTime;
+			for (uint32_t t = 0; t < record.tileCount; ++t)
+			{
+				const TileRecord& tile = tiles[record.firstTile + t];
+				sheet.tiles.push_back(sf::IntRect(tile.left, tile.top, tile.width, tile.height));
+			}
+		}
+		read.tilesheets.push_back(sheet);
+	}
+
+	for (uint32_t i = 0; i < header.animationCount; ++i)
+	{
+		const AnimationRecord& record = animations[i];
+		read.animations.push_back({ string(record.name), string(record.textureName), record.frameCount, record.speed });
+	}
+
+	mm.close();
+	if (!valid) { return false; }
+	list = std::move(read);
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Everything assets.txt lists, plus what was learned from cutting its tilesheets. Filled either by
+// parsing the text file or from the manifest cooked from it.
+struct AssetList
+{
+	struct File
+	{
+		std::string name;
+		std::string path;
+	};
+
+	struct Tilesheet
+	{
+		std::string              name;
+		std::string              path;
+		std::vector<std::string> tileNames;         // given to the non-empty tiles column by column
+		std::vector<sf::IntRect> tiles;             // the non-empty tiles, once sliced
+		bool                     sliced = false;
+		uint64_t                 contentHash = 0;   // hash of the file, zero until it has been read
+		uint64_t                 fileSize = 0;      // size and write time when it was hashed, checked to
+		int64_t                  writeTime = 0;     // tell whether the hash is still right without reading it
+	};
+
+	struct Animation
+	{
+		std::string name;
+		std::string textureName;
+		uint32_t    frameCount = 1;
+		uint32_t    speed = 0;
+	};
+
+	std::vector<File>      textures;
+	std::vector<File>      fonts;
+	std::vector<File>      sounds;
+	std::vector<File>      music;
+	std::vector<Tilesheet> tilesheets;
+	std::vector<Animation> animations;
+};
+
+// A binary AssetList, cooked the first time assets.txt is loaded and memory mapped on later starts so the
+// text file is only parsed again when its hash changes.
+//
+// The file is a header, then fixed size records for every kind of asset, then a string table. Every name
+// and path is stored once in the table and records refer to them by offset. Tilesheets keep their tile
+// rects and the hash, size and write time of their image, so a sheet that hasn't changed is neither hashed
+// nor scanned for empty tiles again.
+class AssetManifest
+{
+public:
+
+	static constexpr uint32_t Version = 1;
+
+	static bool write(const std::string& path, uint64_t sourceHash, const AssetList& list);
+
+	// Returns false if there is no manifest, it was written by another version or cooked from a different
+	// source file. A tilesheet whose image has changed since is given back unsliced with no hash.
+	static bool read(const std::string& path, uint64_t sourceHash, AssetList& list);
+
+	// the size and last write time of a file, zero if it can't be read
+	static void fileStamp(const std::string& path, uint64_t& size, int64_t& writeTime);
+};
\ No newline at end of file
@@ -4,17 +4,138 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define ASSETS_SIMD 1
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	const char* AtlasCachePath = "cache/atlas.txt";
+	const char* ManifestPath = "cache/assets.manifest";
+	const size_t TilesPerScanThread = 1024;  // sheets with fewer tiles are scanned on one thread
+
+	// True if any of width RGBA pixels isn't fully transparent. Read as 32 bit little endian integers the
+	// alpha is the top byte of each pixel.
+	bool hasAlpha(const sf::Uint8* pixels, int width)
+	{
+		int x = 0;
+#ifdef ASSETS_SIMD
+		// sixteen pixels at a time, or-ing them together and testing the alpha bytes once at the end
+		__m128i alpha = _mm_setzero_si128();
+		for (; x + 16 <= width; x += 16)
+		{
+			const __m128i* block = (const __m128i*)(pixels + (size_t)x * 4);
+			__m128i a = _mm_or_si128(_mm_loadu_si128(block), _mm_loadu_si128(block + 1));
+			__m128i b = _mm_or_si128(_mm_loadu_si128(block + 2), _mm_loadu_si128(block + 3));
+			alpha = _mm_or_si128(alpha, _mm_or_si128(a, b));
+		}
+		alpha = _mm_and_si128(alpha, _mm_set1_epi32((int)0xFF000000));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(alpha, _mm_setzero_si128())) != 0xFFFF) { return true; }
+#endif
+		for (; x < width; ++x)
+		{
+			if (pixels[(size_t)x * 4 + 3] != 0) { return true; }
+		}
+		return false;
+	}
+
+	// FNV-1a, only used to notice that something the atlas was built from has changed
+	uint64_t hashBytes(uint64_t hash, const char* data, size_t size)
+	{
+		for (size_t i = 0; i < size; ++i) { hash = (hash ^ (uint8_t)data[i]) * 1099511628211ull; }
+		return hash;
+	}
+}
 
 Assets::Assets()
 {
 
 }
 
-void Assets::loadFromFile(const std::string& path)
+Assets::~Assets()
 {
+	stopLoaders();
+}
+
+void Assets::beginLoading(const std::string& path, bool loadTextures)
+{
+	m_loadTextures = loadTextures;
+	m_loading = true;
+
+	// the manifest depends on the tile size too, since it holds the cut tiles
 	MemoryMapping mm(path);
-	char* fileData = mm.getData();
-	std::stringstream fileContentStream(fileData);
+	std::string text;
+	if (mm.getData()) { text.assign(mm.getData(), mm.getSize()); }
+	mm.close();
+	m_sourceHash = hashBytes(14695981039346656037ull, text.data(), text.size());
+	m_sourceHash = hashBytes(m_sourceHash, (const char*)&m_tileSize, sizeof(m_tileSize));
+
+	if (!AssetManifest::read(ManifestPath, m_sourceHash, m_assetList))
+	{
+		parseAssetFile(text);
+		m_writeManifest = true;
+	}
+
+	// Every id is handed out here, before anything is decoded, and the arrays are sized to match so the
+	// assets never move once they are loaded. Files are only queued here, the loader threads started below
+	// decode them.
+	m_sounds.clear();
+	m_soundBuffers.clear();
+	m_textures.clear();
+	m_fonts.clear();
+	m_animations.clear();
+	m_textureIds.clear();
+	m_animationIds.clear();
+	m_fontIds.clear();
+	m_soundIds.clear();
+
+	m_textures.resize(m_assetList.textures.size());
+	for (uint32_t i = 0; i < m_assetList.textures.size(); ++i)
+	{
+		m_textureIds[m_assetList.textures[i].name] = TextureId{ i };
+		addJob(LoadJob::Texture, i, m_assetList.textures[i].path);
+	}
+	m_fonts.resize(m_assetList.fonts.size());
+	for (uint32_t i = 0; i < m_assetList.fonts.size(); ++i)
+	{
+		m_fontIds[m_assetList.fonts[i].name] = FontId{ i };
+		addJob(LoadJob::Font, i, m_assetList.fonts[i].path);
+	}
+	if (m_loadTextures)
+	{
+		m_soundBuffers.resize(m_assetList.sounds.size());
+		m_sounds.resize(m_assetList.sounds.size());
+		for (uint32_t i = 0; i < m_assetList.sounds.size(); ++i)
+		{
+			m_soundIds[m_assetList.sounds[i].name] = SoundId{ i };
+			addJob(LoadJob::Sound, i, m_assetList.sounds[i].path);
+		}
+	}
+	m_animations.resize(m_assetList.animations.size());
+	for (uint32_t i = 0; i < m_assetList.animations.size(); ++i)
+	{
+		m_animationIds[m_assetList.animations[i].name] = AnimationId{ i };
+	}
+	for (const AssetList::File& music : m_assetList.music) { addMusic(music.name, music.path); }
+
+	// every tilesheet is cut into the same atlas, so they are one job
+	if (!m_assetList.tilesheets.empty()) { addJob(LoadJob::Atlas, 0, AtlasCachePath); }
+
+	size_t loaderCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), m_jobs.size());
+	for (size_t i = 0; i < loaderCount; ++i) { m_loaders.emplace_back(&Assets::loaderLoop, this); }
+}
+
+void Assets::parseAssetFile(const std::string& text)
+{
+	m_assetList = AssetList();
+
+	std::stringstream fileContentStream(text);
 	std::string line, token, identifier;
 	std::vector<std::string> tempVector;
 
@@ -28,7 +149,9 @@ void Assets::loadFromFile(const std::string& path)
 			if (token == "Tilesheet" ||
 				token == "Texture" ||
 				token == "Animation" ||
-				token == "Font")
+				token == "Font" ||
+				token == "Sound" ||
+				token == "Music")
 			{
 				identifier = token;
 				continue;
@@ -38,178 +161,423 @@ void Assets::loadFromFile(const std::string& path)
 
 		// clear the stream to be able to reuse it
 		lineStream.clear();
+
+		// blank lines have no name and path
+		if (tempVector.size() < 2)
+		{
+			tempVector.clear();
+			continue;
+		}
 		
 		// Since the asset.txt file has a specification for how it it structured, the order of the data stays the same.
 		// This means we can specify the index and always get the correct data. E.g. The identifier for what kind of
 		// assets that line represents is always the first string.
 
-			 if (identifier == "Tilesheet") { processTilesheet(tempVector[0], tempVector[1], tempVector); }
-		else if (identifier == "Texture")	{ addTexture(tempVector[0], tempVector[1]); }
-		else if (identifier == "Animation")
+			 if (identifier == "Tilesheet")
+		{
+			// the names after a tilesheet's name and path belong to its non-empty tiles in order
+			AssetList::Tilesheet tilesheet;
+			tilesheet.name = tempVector[0];
+			tilesheet.path = tempVector[1];
+			tilesheet.tileNames.assign(tempVector.begin() + 2, tempVector.end());
+			m_assetList.tilesheets.push_back(tilesheet);
+		}
+		else if (identifier == "Texture")	{ m_assetList.textures.push_back({ tempVector[0], tempVector[1] }); }
+		else if (identifier == "Animation" && tempVector.size() >= 4)
 		{
 			// std::istringstream can be used to store the input strings into a different data type
+			AssetList::Animation animation;
+			animation.name = tempVector[0];
+			animation.textureName = tempVector[1];
 			std::istringstream iss(tempVector[2]);
-			size_t frameCount, interval;
-			iss >> frameCount;
-			iss.str(tempVector[3]);
-			iss >> interval;
-			addAnimation(tempVector[0], tempVector[1], frameCount, interval);
+			iss >> animation.frameCount;
 			iss.clear();
+			iss.str(tempVector[3]);
+			iss >> animation.speed;
+			m_assetList.animations.push_back(animation);
 		}
-		else if (identifier == "Font")		{ addFont(tempVector[0], tempVector[1]); }
+		else if (identifier == "Font")		{ m_assetList.fonts.push_back({ tempVector[0], tempVector[1] }); }
+		else if (identifier == "Sound")		{ m_assetList.sounds.push_back({ tempVector[0], tempVector[1] }); }
+		else if (identifier == "Music")		{ m_assetList.music.push_back({ tempVector[0], tempVector[1] }); }
 
 		// clear vector for next line's data
 		tempVector.clear();
 	}
-
-	// clean up for memory mapping
-	mm.close();
 }
 
-void Assets::addTexture(const std::string& textureName, const std::string& path, bool smooth)
+bool Assets::updateLoading(sf::Time budget)
 {
-	m_textureMap[textureName] = sf::Texture();
+	if (!m_loading) { return true; }
+
+	sf::Clock clock;
+	for (std::unique_ptr<LoadJob>& job : m_jobs)
+	{
+		if (job->finished || !job->decoded.load(std::memory_order_acquire)) { continue; }
+
+		finish(*job);
+		job->finished = true;
+		++m_jobsFinished;
+		if (clock.getElapsedTime() >= budget) { break; }
+	}
+	if (m_jobsFinished < m_jobs.size()) { return false; }
 
-	if (!m_textureMap[textureName].loadFromFile(path))
+	// every texture is ready, so every animation can be made
+	stopLoaders();
+	for (size_t i = 0; i < m_assetList.animations.size(); ++i)
 	{
-		std::cerr << "Could not load texture file: " << path << std::endl;
+		const AssetList::Animation& animation = m_assetList.animations[i];
+		m_animations[i] = makeAnimation(animation.name, animation.textureName, animation.frameCount, animation.speed);
 	}
-	else
+	if (m_writeManifest)
+	{
+		std::error_code error;
+		std::filesystem::create_directories(std::filesystem::path(ManifestPath).parent_path(), error);
+		if (!AssetManifest::write(ManifestPath, m_sourceHash, m_assetList)) { std::cerr << "Could not save the asset manifest to " << ManifestPath << std::endl; }
+		m_writeManifest = false;
+	}
+	m_jobs.clear();
+	m_jobsFinished = 0;
+	m_loading = false;
+	return true;
+}
+
+float Assets::loadingProgress() const
+{
+	if (!m_loading) { return 1.0f; }
+
+	// the animations are made in the last step, so finishing every job doesn't quite count as done
+	return (float)m_jobsFinished / (m_jobs.size() + 1);
+}
+
+bool Assets::isLoaded() const
+{
+	return !m_loading;
+}
+
+void Assets::loadFromFile(const std::string& path, bool loadTextures)
+{
+	beginLoading(path, loadTextures);
+	while (!updateLoading(sf::seconds(1))) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+}
+
+void Assets::addJob(LoadJob::Kind kind, uint32_t index, const std::string& path)
+{
+	m_jobs.push_back(std::make_unique<LoadJob>());
+	m_jobs.back()->kind = kind;
+	m_jobs.back()->index = index;
+	m_jobs.back()->path = path;
+}
+
+void Assets::loaderLoop()
+{
+	// the job list doesn't change while the loaders run, they only take turns on which job is next
+	for (size_t i = m_nextJob++; i < m_jobs.size(); i = m_nextJob++)
 	{
-		m_textureMap[textureName].setSmooth(smooth);
+		decode(*m_jobs[i]);
+		m_jobs[i]->decoded.store(true, std::memory_order_release);
 	}
 }
 
-const sf::Texture& Assets::getTexture(const std::string& textureName) const
+void Assets::stopLoaders()
 {
-	assert(m_textureMap.find(textureName) != m_textureMap.end());
-	return m_textureMap.at(textureName);
+	m_nextJob = m_jobs.size();
+	for (std::thread& loader : m_loaders) { loader.join(); }
+	m_loaders.clear();
+	m_nextJob = 0;
 }
 
-bool Assets::isTileEmpty(const sf::Image& tileImage, Vec2& tileSize)
+void Assets::decode(LoadJob& job)
 {
-	for (int x = 0; x < tileSize.x; ++x)
+	switch (job.kind)
 	{
-		for (int y = 0; y < tileSize.y; ++y)
+	case LoadJob::Texture:
+	{
+		if (m_loadTextures && !job.image.loadFromFile(job.path))
 		{
-			if (tileImage.getPixel(x, y).a != 0)
-			{
-				return false;
-			}
+			std::cerr << "Could not load texture file: " << job.path << std::endl;
+			job.failed = true;
 		}
+		break;
 	}
-	return true;
+	case LoadJob::Atlas: { buildAtlas(); break; }
+	case LoadJob::Font:
+	{
+		if (!job.font.loadFromFile(job.path))
+		{
+			std::cerr << "Could not load font file: " << job.path << std::endl;
+			job.failed = true;
+		}
+		break;
+	}
+	case LoadJob::Sound:
+	{
+		// decoded to samples here, the buffer is made on the main thread with the audio device
+		sf::InputSoundFile file;
+		if (!file.openFromFile(job.path))
+		{
+			std::cerr << "Buffer couldn't load from file." << std::endl;
+			job.failed = true;
+			break;
+		}
+		job.samples.resize((size_t)file.getSampleCount());
+		job.samples.resize((size_t)file.read(job.samples.data(), job.samples.size()));
+		job.channelCount = file.getChannelCount();
+		job.sampleRate = file.getSampleRate();
+		break;
+	}
+	}
+}
+
+void Assets::finish(LoadJob& job)
+{
+	switch (job.kind)
+	{
+	case LoadJob::Texture:
+	{
+		sf::Texture& texture = m_textures[job.index];
+		if (m_loadTextures && !job.failed && texture.loadFromImage(job.image)) { texture.setSmooth(true); }
+		job.image = sf::Image();
+		break;
+	}
+	case LoadJob::Atlas: { if (m_loadTextures) { m_atlas.upload(); } break; }
+	case LoadJob::Font: { m_fonts[job.index] = job.font; break; }
+	case LoadJob::Sound:
+	{
+		if (job.failed) { break; }
+		sf::SoundBuffer& buffer = m_soundBuffers[job.index];
+		if (buffer.loadFromSamples(job.samples.data(), job.samples.size(), job.channelCount, job.sampleRate))
+		{
+			m_sounds[job.index].setBuffer(buffer);
+		}
+		job.samples.clear();
+		break;
+	}
+	}
+}
+
+uint64_t Assets::atlasKey() const
+{
+	// the tilesheets, the hashes of the files they name and how the tiles are cut and packed
+	uint64_t hash = 14695981039346656037ull;
+	std::string settings = "1 " + std::to_string((int)m_tileSize.x) + " " + std::to_string((int)m_tileSize.y) + " " + std::to_string(TextureAtlas::Padding);
+	hash = hashBytes(hash, settings.data(), settings.size());
+	for (const AssetList::Tilesheet& sheet : m_assetList.tilesheets)
+	{
+		hash = hashBytes(hash, sheet.name.c_str(), sheet.name.size() + 1);
+		hash = hashBytes(hash, sheet.path.c_str(), sheet.path.size() + 1);
+		for (const std::string& name : sheet.tileNames) { hash = hashBytes(hash, name.c_str(), name.size() + 1); }
+		hash = hashBytes(hash, (const char*)&sheet.contentHash, sizeof(sheet.contentHash));
+	}
+	return hash;
 }
 
-void Assets::processTilesheet(const std::string& tilesheetName, const std::string& path, std::vector<std::string>& tileNames)
+void Assets::buildAtlas()
 {
-	sf::Image tilesheet;
-	if (!tilesheet.loadFromFile(path))
+	// Tiles used to be a texture each. Packed together they can be drawn in one call, and the packed
+	// pages are saved so the next start only loads them unless a tilesheet changed. Runs on a loader
+	// thread, the pages are uploaded when the job is finished.
+	std::vector<AssetList::Tilesheet>& sheets = m_assetList.tilesheets;
+
+	// Only sheets the manifest has no hash for are read here, the others are known to be unchanged by
+	// their size and write time. The bytes are kept to decode them from if the atlas has to be built.
+	std::vector<std::vector<char>> files(sheets.size());
+	for (size_t i = 0; i < sheets.size(); ++i)
 	{
-		std::cerr << "Could not load tilesheet: " << path << std::endl;
+		if (sheets[i].contentHash != 0) { continue; }
+
+		AssetManifest::fileStamp(sheets[i].path, sheets[i].fileSize, sheets[i].writeTime);
+		std::ifstream file(sheets[i].path, std::ios::binary);
+		files[i].assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		sheets[i].contentHash = hashBytes(14695981039346656037ull, files[i].data(), files[i].size());
+		sheets[i].sliced = false;
+		m_writeManifest = true;
 	}
-	else
+
+	uint64_t key = atlasKey();
+	if (m_atlas.load(AtlasCachePath, key)) { return; }
+
+	// Decoding is most of the work, so every sheet is decoded and cut on a thread of its own. Sheets the
+	// manifest already has the tiles of aren't cut again. The sheets stay alive until build() has copied
+	// the tiles out of them.
+	std::vector<sf::Image> tilesheets(sheets.size());
+	std::vector<uint8_t> sliced(sheets.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < sheets.size(); ++i)
 	{
-		const int numberOfRows = (int)(tilesheet.getSize().y / m_tileSize.y);
-		const int numberOfColumns = (int)(tilesheet.getSize().x / m_tileSize.x);
+		threads.emplace_back([this, i, &sheets, &files, &tilesheets, &sliced]()
+		{
+			bool loaded = files[i].empty() ? tilesheets[i].loadFromFile(sheets[i].path) : tilesheets[i].loadFromMemory(files[i].data(), files[i].size());
+			if (!loaded)
+			{
+				std::cerr << "Could not load tilesheet: " << sheets[i].path << std::endl;
+				return;
+			}
+			if (!sheets[i].sliced)
+			{
+				sheets[i].tiles.clear();
+				sliceTilesheet(tilesheets[i], m_tileSize, sheets[i].tiles);
+				sliced[i] = 1;
+			}
+		});
+	}
+	for (std::thread& thread : threads) { thread.join(); }
+
+	for (size_t i = 0; i < sheets.size(); ++i)
+	{
+		AssetList::Tilesheet& sheet = sheets[i];
+		if (sliced[i])
+		{
+			sheet.sliced = true;
+			m_writeManifest = true;
+		}
+		if (sheet.tiles.size() > sheet.tileNames.size()) { std::cerr << "Tilesheet " << sheet.name << " has more tiles than names" << std::endl; }
+		for (size_t t = 0; t < sheet.tiles.size() && t < sheet.tileNames.size(); ++t)
+		{
+			m_atlas.add(sheet.tileNames[t], tilesheets[i], sheet.tiles[t]);
+		}
+	}
+	m_atlas.build();
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(AtlasCachePath).parent_path(), error);
+	if (!m_atlas.save(AtlasCachePath, key)) { std::cerr << "Could not save the texture atlas to " << AtlasCachePath << std::endl; }
+}
 
-		// Initialize the tile object
-		sf::Image tile;
-		tile.create((unsigned int)m_tileSize.x, (unsigned int)m_tileSize.y);
+void Assets::sliceTilesheet(const sf::Image& tilesheet, const Vec2& tileSize, std::vector<sf::IntRect>& tiles)
+{
+	const int tileWidth = (int)tileSize.x;
+	const int tileHeight = (int)tileSize.y;
+	const int numberOfRows = (int)tilesheet.getSize().y / tileHeight;
+	const int numberOfColumns = (int)tilesheet.getSize().x / tileWidth;
+	const sf::Uint8* pixels = tilesheet.getPixelsPtr();
+	const size_t pitch = (size_t)tilesheet.getSize().x * 4;
 
-		int tileNameIndex = 2;
-		for (size_t c = 0; c < numberOfColumns; ++c)
+	// Tilesheets are not always filled to the edge of their grid, so empty tiles are skipped. The pixels
+	// are read in place a whole pixel row at a time, which keeps the reads in memory order, and each tile
+	// stops being read once something opaque has been found in it. A big sheet's rows of tiles are split
+	// between threads.
+	std::vector<uint8_t> opaque((size_t)numberOfColumns * numberOfRows);
+	auto scanTileRows = [&](int first, int last)
+	{
+		for (int r = first; r < last; ++r)
 		{
-			for (size_t r = 0; r < numberOfRows; ++r)
+			for (int y = r * tileHeight; y < (r + 1) * tileHeight; ++y)
 			{
-				// Create a rect at the position the tile exists on the tilesheet
-				sf::IntRect tileRect((int)(c * m_tileSize.x), (int)(r * m_tileSize.y), (int)m_tileSize.x, (int)m_tileSize.y);
-
-				// Copy the pixels in the subregion defined by the sf::IntRect.
-				// SFML documentation says this is a slow pixel copy so will look to optimze in the future.
-				// Since tilesheets are not always symmetrical with their grid, that can leave empty space in the tilesheet.
-				// sf::Image has a function to get a pixel at a position so we are using that function to ignore empty space.
-				// For this reason, sf::Image is used over sf::Texture.
-				tile.copy(tilesheet, 0, 0, tileRect);
-				
-				if (!isTileEmpty(tile, m_tileSize))
+				const sf::Uint8* row = pixels + y * pitch;
+				for (int c = 0; c < numberOfColumns; ++c)
 				{
-					// Create a texture from the sf::Image to create a tile usable by the animation system.
-					sf::Texture texTile;
-					texTile.loadFromImage(tile);
-					m_textureMap[tileNames[tileNameIndex]] = texTile;
-					++tileNameIndex;
+					uint8_t& tile = opaque[(size_t)c * numberOfRows + r];
+					if (!tile) { tile = hasAlpha(row + (size_t)c * tileWidth * 4, tileWidth); }
 				}
 			}
 		}
+	};
+
+	int threadCount = (int)std::max(1u, std::thread::hardware_concurrency());
+	threadCount = std::min(threadCount, std::max(1, (int)(opaque.size() / TilesPerScanThread)));
+	threadCount = std::min(threadCount, std::max(1, numberOfRows));
+	std::vector<std::thread> threads;
+	for (int t = 1; t < threadCount; ++t)
+	{
+		threads.emplace_back(scanTileRows, numberOfRows * t / threadCount, numberOfRows * (t + 1) / threadCount);
+	}
+	scanTileRows(0, numberOfRows / threadCount);
+	for (std::thread& thread : threads) { thread.join(); }
+
+	// tiles are named column by column
+	for (int c = 0; c < numberOfColumns; ++c)
+	{
+		for (int r = 0; r < numberOfRows; ++r)
+		{
+			if (opaque[(size_t)c * numberOfRows + r]) { tiles.push_back(sf::IntRect(c * tileWidth, r * tileHeight, tileWidth, tileHeight)); }
+		}
+	}
+}
+
+Animation Assets::makeAnimation(const std::string& animationName, const std::string& textureName, size_t frameCount, size_t speed) const
+{
+	// tiles are a region of an atlas page, other textures are used whole
+	if (const AtlasRegion* region = m_atlas.region(textureName))
+	{
+		return Animation(animationName, m_atlas.page(region->page), region->rect, frameCount, speed);
 	}
+
+	TextureId texture = textureId(textureName);
+	if (!texture.isValid())
+	{
+		std::cerr << "Animation " << animationName << " uses unknown texture " << textureName << std::endl;
+		return Animation();
+	}
+	return Animation(animationName, getTexture(texture), frameCount, speed);
 }
 
-void Assets::addAnimation(const std::string& animationName, const std::string& textureName, size_t frameCount, size_t speed)
+TextureId Assets::textureId(const std::string& textureName) const
 {
-	m_animationMap[animationName] = Animation(animationName, getTexture(textureName), frameCount, speed);
+	auto it = m_textureIds.find(textureName);
+	return it != m_textureIds.end() ? it->second : TextureId();
 }
 
-const Animation& Assets::getAnimation(const std::string& animationName) const
+AnimationId Assets::animationId(const std::string& animationName) const
 {
-	assert(m_animationMap.find(animationName) != m_animationMap.end());
-	return m_animationMap.at(animationName);
+	auto it = m_animationIds.find(animationName);
+	return it != m_animationIds.end() ? it->second : AnimationId();
 }
 
-void Assets::addFont(const std::string& fontName, const std::string& path)
+FontId Assets::fontId(const std::string& fontName) const
 {
-	m_fontMap[fontName] = sf::Font();
-	if (!m_fontMap[fontName].loadFromFile(path))
-	{
-		std::cerr << "Could not load font file: " << path << std::endl;
-	}
+	auto it = m_fontIds.find(fontName);
+	return it != m_fontIds.end() ? it->second : FontId();
 }
 
-const sf::Font& Assets::getFont(const std::string& fontName) const
+SoundId Assets::soundId(const std::string& soundName) const
 {
-	assert(m_fontMap.find(fontName) != m_fontMap.end());
-	return m_fontMap.at(fontName);
+	auto it = m_soundIds.find(soundName);
+	return it != m_soundIds.end() ? it->second : SoundId();
 }
 
-void Assets::addSound(const std::string& soundName, const std::string& path)
+const sf::Texture& Assets::getTexture(TextureId id) const
 {
-	sf::SoundBuffer buffer;
-	if (buffer.loadFromFile(path))
-	{
-		m_soundBufferMap[soundName] = buffer;
-		m_soundMap[soundName] = sf::Sound(m_soundBufferMap[soundName]);
-	}
-	else { std::cerr << "Buffer couldn't load from file."; }
+	assert(id.index < m_textures.size());
+	return m_textures[id.index];
 }
 
-sf::Sound& Assets::getSound(const std::string& soundName)
+const Animation& Assets::getAnimation(AnimationId id) const
 {
-	return m_soundMap.at(soundName);
+	if (!id.isValid()) { return m_noAnimation; }
+	assert(id.index < m_animations.size());
+	return m_animations[id.index];
 }
 
-void Assets::addMusic(const std::string& musicName, const std::string& path)
+const sf::Font& Assets::getFont(FontId id) const
 {
-	m_musicMap[musicName] = path;
+	assert(id.index < m_fonts.size());
+	return m_fonts[id.index];
 }
 
-const std::string& Assets::getMusic(const std::string& musicName) const
+sf::Sound& Assets::getSound(SoundId id)
 {
-	return m_musicMap.at(musicName);
+	assert(id.index < m_sounds.size());
+	return m_sounds[id.index];
 }
 
-const std::map<std::string, sf::Texture>& Assets::getTextures() const
+size_t Assets::animationCount() const
 {
-	return m_textureMap;
+	return m_animations.size();
 }
 
-const std::map<std::string, Animation>& Assets::getAnimations() const
+void Assets::addMusic(const std::string& musicName, const std::string& path)
 {
-	return m_animationMap;
+	m_musicMap[musicName] = path;
+}
+
+const std::string& Assets::getMusic(const std::string& musicName) const
+{
+	return m_musicMap.at(musicName);
 }
 
-const std::map<std::string, sf::Sound>& Assets::getSounds() const
+const TextureAtlas& Assets::getAtlas() const
 {
-	return m_soundMap;
+	return m_atlas;
 }
 
 const std::map<std::string, std::string>& Assets::getMusic() const
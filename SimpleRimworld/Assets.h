@@ -1,40 +1,125 @@
 #pragma once
 
 #include "Animation.h"
+#include "AssetId.h"
+#include "TextureAtlas.h"
+#include "AssetManifest.h"
 #include <SFML/Audio.hpp>
 
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+// Assets are loaded in two halves. The slow part of every file, decoding it, runs on loader threads, and
+// the main thread then finishes each one: uploading textures, which needs the graphics context, and
+// making sound buffers. Animations are made last, once every texture they could use is ready.
+//
+// Every asset lives in an array of its kind and is referred to by its index, wrapped in a typed id. The
+// ids are handed out in asset file order as soon as the file has been read, and the arrays are sized then
+// so nothing in them moves. Names are only turned into ids when something is loaded or edited.
 class Assets
 {
-	std::map<std::string, sf::Texture>     m_textureMap;
-	std::map<std::string, Animation>       m_animationMap;
-	std::map<std::string, sf::Font>        m_fontMap;
-	std::map<std::string, sf::SoundBuffer> m_soundBufferMap;
-	std::map<std::string, sf::Sound>       m_soundMap;
+	// One asset decoded on a loader thread and finished on the main thread. Which fields are used depends on the kind.
+	struct LoadJob
+	{
+		enum Kind { Texture, Atlas, Font, Sound };
+
+		Kind                   kind = Texture;
+		uint32_t               index = 0;         // where the asset goes in the array of its kind
+		std::string            path;
+		sf::Image              image;             // a texture's pixels until they are uploaded
+		sf::Font               font;
+		std::vector<sf::Int16> samples;           // a sound's decoded samples
+		unsigned int           channelCount = 0;
+		unsigned int           sampleRate = 0;
+		bool                   failed = false;
+		std::atomic<bool>      decoded = false;   // set by the loader thread once the fields above are filled in
+		bool                   finished = false;
+	};
+
+	std::vector<sf::Texture>			   m_textures;
+	std::vector<Animation>				   m_animations;
+	Animation							   m_noAnimation;    // given for invalid ids, an entity without an animation has one
+	std::vector<sf::Font>				   m_fonts;
+	std::vector<sf::SoundBuffer>		   m_soundBuffers;
+	std::vector<sf::Sound>				   m_sounds;
+	std::unordered_map<std::string, TextureId>   m_textureIds;
+	std::unordered_map<std::string, AnimationId> m_animationIds;
+	std::unordered_map<std::string, FontId>      m_fontIds;
+	std::unordered_map<std::string, SoundId>     m_soundIds;
 	std::map<std::string, std::string>	   m_musicMap;
 	Vec2								   m_tileSize = { 64, 64 };
+	bool								   m_loadTextures = true;
+	TextureAtlas						   m_atlas;          // every tilesheet tile, cut out once and cached on disk
+	AssetList							   m_assetList;      // what the asset file lists, from the manifest when it is current
+	uint64_t							   m_sourceHash = 0; // hash of the asset file the list came from
+	bool								   m_writeManifest = false;
+
+	std::vector<std::unique_ptr<LoadJob>>  m_jobs;
+	std::vector<std::thread>			   m_loaders;
+	std::atomic<size_t>					   m_nextJob = 0;    // the next job a loader thread will take
+	size_t								   m_jobsFinished = 0;
+	bool								   m_loading = false;
+
+	void addJob(LoadJob::Kind kind, uint32_t index, const std::string& path);
+	void loaderLoop();
+	void decode(LoadJob& job);
+	void finish(LoadJob& job);
+	void stopLoaders();
+
+	void parseAssetFile(const std::string& text);
 
-	void addTexture(const std::string& textureName, const std::string& path, bool smooth = true);
-	bool isTileEmpty(const sf::Image& tileImage, Vec2& tileSize);
-	void processTilesheet(const std::string& tilesheetName, const std::string& path, std::vector<std::string>& tileNames);
-	void addAnimation(const std::string& animationName, const std::string& textureName, size_t frameCount, size_t speed);
-	void addFont(const std::string& fontName, const std::string& path);
-	void addSound(const std::string& soundName, const std::string& path);
+	uint64_t atlasKey() const;
+	void buildAtlas();
+	Animation makeAnimation(const std::string& animationName, const std::string& textureName, size_t frameCount, size_t speed) const;
 	void addMusic(const std::string& musicName, const std::string& path);
 
 public:
 	
 	Assets();
+	~Assets();
 
-	void loadFromFile(const std::string& path);
+	Assets(const Assets&) = delete;
+	Assets& operator = (const Assets&) = delete;
 
-	const std::map<std::string, sf::Texture>& getTextures() const;
-	const std::map<std::string, Animation>& getAnimations() const;
-	const std::map<std::string, sf::Sound>& getSounds() const;
+	// Reads the asset file and starts decoding everything in it on loader threads. updateLoading() then has
+	// to be called on the main thread until it returns true.
+	//
+	// The file is only parsed when it has changed since the manifest in the cache was cooked from it,
+	// otherwise the manifest is used. The manifest is cooked again once loading is done if anything in it
+	// changed.
+	//
+	// Without textures only the names are registered, with empty textures behind them, and no sounds are
+	// loaded, so nothing needs a graphics context or an audio device. Used by headless runs.
+	void beginLoading(const std::string& path, bool loadTextures = true);
+
+	// Finishes decoded assets until budget has been spent, at least one per call if one is ready. Returns
+	// true once everything is loaded.
+	bool updateLoading(sf::Time budget);
+	float loadingProgress() const;
+	bool isLoaded() const;
+
+	// beginLoading() and updateLoading() until done
+	void loadFromFile(const std::string& path, bool loadTextures = true);
+
+	// Look a name up once. The id is invalid if there is no such asset.
+	TextureId textureId(const std::string& textureName) const;
+	AnimationId animationId(const std::string& animationName) const;
+	FontId fontId(const std::string& fontName) const;
+	SoundId soundId(const std::string& soundName) const;
+
+	const TextureAtlas& getAtlas() const;
 	const std::map<std::string, std::string>& getMusic() const;
+	size_t animationCount() const;
+
+	// Lists the non-empty tiles of a decoded tilesheet column by column. Keeps no state, so several
+	// sheets can be cut at once.
+	static void sliceTilesheet(const sf::Image& tilesheet, const Vec2& tileSize, std::vector<sf::IntRect>& tiles);
 
-	const sf::Texture& getTexture(const std::string& textureName) const;
-	const Animation& getAnimation(const std::string& animationName) const;
-	const sf::Font& getFont(const std::string& fontName) const;
-	sf::Sound& getSound(const std::string& soundName);
+	const sf::Texture& getTexture(TextureId id) const;
+	const Animation& getAnimation(AnimationId id) const;
+	const sf::Font& getFont(FontId id) const;
+	sf::Sound& getSound(SoundId id);
 	const std::string& getMusic(const std::string& musicName) const;
 };
\ No newline at end of file
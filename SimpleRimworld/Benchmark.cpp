@@ -0,0 +1,711 @@
+#include "Benchmark.h"
+#include "Assets.h"
+#include "EntityManager.h"
+#include "TileGrid.h"
+#include "HierarchicalPathfinder.h"
+#include "Physics.h"
+
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	struct Entry
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	double millisecondsSince(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// The fastest of several runs of f, so a single hiccup doesn't decide the result.
+	template <typename F>
+	double bestOf(int runs, F&& f)
+	{
+		double best = 0;
+		for (int i = 0; i < runs; ++i)
+		{
+			auto start = Clock::now();
+			f();
+			double ms = millisecondsSince(start);
+			if (i == 0 || ms < best) { best = ms; }
+		}
+		return best;
+	}
+
+	// keeps the compiler from dropping loops whose results are otherwise unused
+	volatile double g_sink = 0;
+
+	// The animation names map_home.txt uses, so names copied per entity cost what they did in the game.
+	const char* const MapAnimationNames[] = { "Tiles", "Grass", "Tile", "FloorArrow", "TilesCracked", "TilesDecorative",
+		"FloorWallDamaged", "FloorWall", "FloorTree", "Water", "TilesCenter", "FloorPlants", "FloorTrap", "FloorCoffin",
+		"FloorWallSecret", "FloorWallHalf", "FloorTable", "FloorDragon", "FloorChest", "FloorChair" };
+	const size_t MapAnimationNameCount = sizeof(MapAnimationNames) / sizeof(MapAnimationNames[0]);
+
+	// Heap memory behind a string, nothing when it fits in the string itself.
+	size_t heapBytes(const std::string& text)
+	{
+		return text.capacity() > std::string().capacity() ? text.capacity() + 1 : 0;
+	}
+
+	// Copies of the original Animation and CAnimation. Before clips were shared through Assets every
+	// animated entity carried its own sprite, name and frame counters.
+	struct OldAnimation
+	{
+		sf::Sprite  sprite;
+		size_t      frameCount = 1;
+		size_t      currentFrame = 0;
+		size_t      gameFrame = 0;
+		size_t      speed = 0;
+		Vec2        size = { 1, 1 };
+		std::string name = "none";
+	};
+
+	class OldCAnimation : public Component
+	{
+	public:
+		OldAnimation animation;
+		bool         repeat = false;
+	};
+
+	// The layout entities had before components moved into pools: every entity carrying one of each.
+	struct InlineEntity
+	{
+		bool           active = true;
+		std::string    tag;
+		size_t         id = 0;
+		CTransform     transform;
+		CInput         input;
+		CLifespan      lifespan;
+		CDamage        damage;
+		CInvincibility invincibility;
+		CHealth        health;
+		OldCAnimation  animation;
+		CState         state;
+		CBoundingBox   boundingBox;
+		CFollowPlayer  followPlayer;
+		CPatrol        patrol;
+		CDraggable     draggable;
+	};
+
+	void components()
+	{
+		// a home map of 100k grid entities, one in five a Tile with a bounding box like map_home.txt
+		const size_t count = 100000;
+		std::cout << "components: " << count << " entities, 1 in 5 with a bounding box\n";
+
+		std::vector<InlineEntity> inlineEntities(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			InlineEntity& e = inlineEntities[i];
+			e.tag = (i % 5 == 0) ? "Tile" : "Decoration";
+			e.id = i;
+			e.transform = CTransform(Vec2((float)(i % 1000) * 64, (float)(i / 1000) * 64));
+			e.transform.has = true;
+			e.animation.animation.name = MapAnimationNames[i % MapAnimationNameCount];
+			e.animation.animation.size = Vec2(64, 64);
+			e.animation.repeat = true;
+			e.animation.has = true;
+			if (i % 5 == 0)
+			{
+				e.boundingBox = CBoundingBox(e.transform.pos, Vec2(0, 0), Vec2(64, 64), true, true);
+				e.boundingBox.has = true;
+			}
+		}
+
+		EntityManager entities;
+		for (size_t i = 0; i < count; ++i)
+		{
+			Entity& e = entities.addEntity((i % 5 == 0) ? "Tile" : "Decoration");
+			e.add<CTransform>(Vec2((float)(i % 1000) * 64, (float)(i / 1000) * 64));
+			e.add<CAnimation>(AnimationId{ (uint32_t)(i % 7) }, 0, true);
+			if (i % 5 == 0) { e.add<CBoundingBox>(e.get<CTransform>().pos, Vec2(0, 0), Vec2(64, 64), true, true); }
+		}
+		entities.update();
+
+		// what a render pass reads: every position and animation
+		double inlineDraw = bestOf(20, [&]
+		{
+			double sum = 0;
+			for (const InlineEntity& e : inlineEntities)
+			{
+				if (e.transform.has && e.animation.has) { sum += e.transform.pos.x + e.animation.animation.frameCount; }
+			}
+			g_sink = sum;
+		});
+		double pooledDraw = bestOf(20, [&]
+		{
+			double sum = 0;
+			entities.view<CTransform, CAnimation>().each([&](Entity&, CTransform& transform, CAnimation& animation)
+			{
+				sum += transform.pos.x + animation.id.index;
+			});
+			g_sink = sum;
+		});
+
+		// what the collision pass reads: only the entities with a bounding box
+		double inlineBoxes = bestOf(20, [&]
+		{
+			double sum = 0;
+			for (const InlineEntity& e : inlineEntities)
+			{
+				if (e.boundingBox.has) { sum += e.boundingBox.pos.x + e.boundingBox.halfSize.x; }
+			}
+			g_sink = sum;
+		});
+		double pooledBoxes = bestOf(20, [&]
+		{
+			double sum = 0;
+			ComponentPool<CBoundingBox>& boxes = entities.getComponents<CBoundingBox>();
+			for (size_t i = 0; i < boxes.size(); ++i) { sum += boxes.at(i).pos.x + boxes.at(i).halfSize.x; }
+			g_sink = sum;
+		});
+
+		EntityMemoryStats stats = entities.memoryStats();
+		size_t inlineBytes = inlineEntities.capacity() * sizeof(InlineEntity);
+		for (const InlineEntity& e : inlineEntities) { inlineBytes += heapBytes(e.tag) + heapBytes(e.animation.animation.name); }
+		size_t pooledBytes = stats.entityBytes + stats.componentBytes;
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << "  every component inline: " << sizeof(InlineEntity) << " bytes per entity, " << inlineBytes / 1024 << " KiB with the names\n";
+		std::cout << "  component pools:        " << pooledBytes / 1024 << " KiB (entities " << stats.entityBytes / 1024
+			<< " KiB, components " << stats.componentBytes / 1024 << " KiB)\n";
+		std::cout << "  transform + animation:  inline " << inlineDraw << " ms, pools " << pooledDraw << " ms\n";
+		std::cout << "  bounding boxes:         inline " << inlineBoxes << " ms, pools " << pooledBoxes << " ms\n";
+	}
+
+	void views()
+	{
+		// 100k entities with a transform, a share of them with a bounding box too
+		const size_t count = 100000;
+		std::cout << "views: " << count << " entities, a filter loop over getEntities() against view<CTransform, CBoundingBox>()\n";
+		std::cout << std::fixed << std::setprecision(3);
+
+		const size_t matchEvery[] = { 100, 10, 1 };
+		for (size_t every : matchEvery)
+		{
+			EntityManager entities;
+			for (size_t i = 0; i < count; ++i)
+			{
+				Entity& e = entities.addEntity("Tile");
+				e.add<CTransform>(Vec2((float)i, 0));
+				if (i % every == 0) { e.add<CBoundingBox>(Vec2((float)i, 0), Vec2(0, 0), Vec2(64, 64)); }
+			}
+			entities.update();
+
+			double filter = bestOf(50, [&]
+			{
+				double sum = 0;
+				for (Entity* e : entities.getEntities())
+				{
+					if (e->has<CTransform>() && e->has<CBoundingBox>()) { sum += e->get<CTransform>().pos.x + e->get<CBoundingBox>().size.x; }
+				}
+				g_sink = sum;
+			});
+			double view = bestOf(50, [&]
+			{
+				double sum = 0;
+				entities.view<CTransform, CBoundingBox>().each([&](Entity&, CTransform& transform, CBoundingBox& box)
+				{
+					sum += transform.pos.x + box.size.x;
+				});
+				g_sink = sum;
+			});
+
+			std::cout << "  " << std::setw(3) << 100 / every << "% match: filter loop " << filter << " ms, view " << view << " ms\n";
+		}
+	}
+
+	void tileGrid()
+	{
+		std::cout << std::fixed << std::setprecision(3);
+
+		// a full 1024x1024 map loaded one cell at a time in file order, one cell in ten blocking
+		const int side = 1024;
+		TileGrid grid;
+		grid.resize(0, 0);
+		double load = bestOf(3, [&]
+		{
+			grid.resize(0, 0);
+			for (int y = 0; y < side; ++y)
+			{
+				for (int x = 0; x < side; ++x)
+				{
+					bool blocking = (x * 7 + y * 13) % 10 == 0;
+					grid.set(x, y, EntityHandle(), AnimationId(), blocking, blocking);
+				}
+			}
+			grid.fitToContents();
+		});
+		size_t bytes = grid.memoryUsage();
+		std::cout << "tileGrid: " << side << "x" << side << " cells, " << grid.width() << "x" << grid.height() << " after fitting\n";
+		std::cout << "  memory " << bytes / 1024 << " KiB, " << (double)bytes / ((double)side * side) << " bytes per cell\n";
+		std::cout << "  filled in " << load << " ms\n";
+
+		// blocking lookups at scattered cells, as pathfinding and vision do them
+		const size_t lookups = 1000000;
+		double lookup = bestOf(5, [&]
+		{
+			uint32_t seed = 12345;
+			size_t blocked = 0;
+			for (size_t i = 0; i < lookups; ++i)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				int x = (int)(seed >> 8) % side;
+				int y = (int)(seed >> 20) % side;
+				blocked += grid.blocksMove(x, y) ? 1 : 0;
+			}
+			g_sink = (double)blocked;
+		});
+		std::cout << "  " << lookups << " blocksMove lookups in " << lookup << " ms, " << lookup * 1e6 / lookups << " ns each\n";
+
+		// the placement check the editor did before the grid: scan every tile for one in the cell
+		const int smallSide = 100;
+		EntityManager entities;
+		TileGrid smallGrid(0, 0, Vec2(64, 64));
+		for (int y = 0; y < smallSide; ++y)
+		{
+			for (int x = 0; x < smallSide; ++x)
+			{
+				Entity& e = entities.addEntity("Tile");
+				e.add<CTransform>(smallGrid.cellCenter(x, y));
+				smallGrid.set(x, y, e.handle(), AnimationId(), false, false);
+			}
+		}
+		entities.update();
+
+		const size_t checks = 1000;
+		double scan = bestOf(3, [&]
+		{
+			size_t occupied = 0;
+			for (size_t i = 0; i < checks; ++i)
+			{
+				Vec2 center = smallGrid.cellCenter((int)(i * 37 % smallSide), (int)(i * 91 % smallSide));
+				for (Entity* e : entities.getEntities())
+				{
+					if (e->get<CTransform>().pos == center) { ++occupied; break; }
+				}
+			}
+			g_sink = (double)occupied;
+		});
+		double direct = bestOf(3, [&]
+		{
+			size_t occupied = 0;
+			for (size_t i = 0; i < checks; ++i)
+			{
+				occupied += smallGrid.occupied((int)(i * 37 % smallSide), (int)(i * 91 % smallSide)) ? 1 : 0;
+			}
+			g_sink = (double)occupied;
+		});
+		std::cout << "  " << checks << " placement checks on " << smallSide << "x" << smallSide << ": entity scan " << scan << " ms, grid " << direct << " ms\n";
+	}
+
+	// The walking cost of a path of adjacent cells, as Pathfinder counts it.
+	uint32_t pathCost(const Path& path)
+	{
+		uint32_t cost = 0;
+		for (size_t i = 1; i < path.size(); ++i)
+		{
+			bool diagonal = path[i].x != path[i - 1].x && path[i].y != path[i - 1].y;
+			cost += diagonal ? Pathfinder::DiagonalCost : Pathfinder::StraightCost;
+		}
+		return cost;
+	}
+
+	void hierarchicalPaths()
+	{
+		std::cout << std::fixed << std::setprecision(3);
+
+		// a generated map: scattered rocks and walled rooms with one doorway each
+		const int side = 2048;
+		std::mt19937 rng(11);
+		std::vector<uint8_t> blocked((size_t)side * side, 0);
+		for (uint8_t& cell : blocked) { cell = rng() % 100 < 8; }
+		for (int room = 0; room < side * side / 2000; ++room)
+		{
+			int x = rng() % side, y = rng() % side, w = 6 + rng() % 20, h = 6 + rng() % 20;
+			for (int i = 0; i <= w; ++i)
+			{
+				for (int j = 0; j <= h; ++j)
+				{
+					bool wall = i == 0 || i == w || j == 0 || j == h;
+					if (wall && x + i < side && y + j < side) { blocked[(size_t)(y + j) * side + x + i] = 1; }
+				}
+			}
+			if (x + w / 2 < side) { blocked[(size_t)y * side + x + w / 2] = 0; }
+		}
+
+		TileGrid grid(side, side, Vec2(64, 64));
+		for (int y = 0; y < side; ++y)
+		{
+			for (int x = 0; x < side; ++x)
+			{
+				bool block = blocked[(size_t)y * side + x] != 0;
+				grid.set(x, y, EntityHandle(), AnimationId(), block, false);
+			}
+		}
+
+		// 500 queries between free cells at least half the map apart
+		const size_t queries = 500;
+		std::vector<GridCell> ends;
+		while (ends.size() < queries * 2)
+		{
+			GridCell from = { (int)(rng() % side), (int)(rng() % side) };
+			GridCell to = { (int)(rng() % side), (int)(rng() % side) };
+			if (blocked[(size_t)from.y * side + from.x] || blocked[(size_t)to.y * side + to.x]) { continue; }
+			if (std::abs(from.x - to.x) + std::abs(from.y - to.y) < side / 2) { continue; }
+			ends.push_back(from);
+			ends.push_back(to);
+		}
+
+		std::cout << "hierarchicalPaths: " << side << "x" << side << " generated map, " << queries << " long queries\n";
+
+		HierarchicalPathfinder hierarchical(grid);
+		HierarchicalPath route;
+		auto start = Clock::now();
+		hierarchical.findPath(ends[0].x, ends[0].y, ends[0].x, ends[0].y, route);
+		std::cout << "  HPA* build " << millisecondsSince(start) << " ms, " << hierarchical.nodeCount() << " entrance nodes\n";
+
+		size_t found = 0;
+		start = Clock::now();
+		for (size_t i = 0; i < queries; ++i)
+		{
+			found += hierarchical.findPath(ends[2 * i].x, ends[2 * i].y, ends[2 * i + 1].x, ends[2 * i + 1].y, route) ? 1 : 0;
+		}
+		double hpa = millisecondsSince(start);
+		std::cout << "  HPA* " << hpa << " ms for all " << queries << " (" << hpa / queries << " ms each), " << found << " found\n";
+
+		// plain A* is slow enough at this size that only a sample is timed and compared
+		const size_t sample = 20;
+		Pathfinder pathfinder(grid, 0);
+		Path path, leg, refined;
+		double astar = 0, worstRatio = 0, ratioSum = 0;
+		size_t compared = 0;
+		for (size_t i = 0; i < sample; ++i)
+		{
+			start = Clock::now();
+			bool reached = pathfinder.findPath(ends[2 * i].x, ends[2 * i].y, ends[2 * i + 1].x, ends[2 * i + 1].y, path);
+			astar += millisecondsSince(start);
+			if (!reached || !hierarchical.findPath(ends[2 * i].x, ends[2 * i].y, ends[2 * i + 1].x, ends[2 * i + 1].y, route)) { continue; }
+
+			refined.clear();
+			for (size_t l = 0; l + 1 < route.waypoints.size(); ++l)
+			{
+				hierarchical.refineLeg(route, l, leg);
+				if (!refined.empty()) { refined.pop_back(); }
+				refined.insert(refined.end(), leg.begin(), leg.end());
+			}
+			double ratio = (double)pathCost(refined) / pathCost(path);
+			ratioSum += ratio;
+			if (ratio > worstRatio) { worstRatio = ratio; }
+			++compared;
+		}
+		std::cout << "  A* " << astar / sample << " ms each over " << sample << " of them, about " << astar / sample * queries << " ms for all " << queries << "\n";
+		if (compared > 0)
+		{
+			std::cout << "  fully refined HPA* path cost against A*: " << ratioSum / compared << " on average, " << worstRatio << " at worst\n";
+		}
+
+		// a couple of walls going up only rebuilds the clusters around them
+		size_t rebuilt = hierarchical.clustersRebuilt();
+		grid.set(side / 2, side / 2, EntityHandle(), AnimationId(), true, false);
+		grid.set(side / 2 + 15, side / 2 + 3, EntityHandle(), AnimationId(), true, false);
+		start = Clock::now();
+		hierarchical.findPath(ends[0].x, ends[0].y, ends[1].x, ends[1].y, route);
+		std::cout << "  after 2 cells change: " << millisecondsSince(start) << " ms for the next query, " << hierarchical.clustersRebuilt() - rebuilt << " clusters rebuilt\n";
+	}
+
+	void overlaps()
+	{
+		std::cout << std::fixed << std::setprecision(3);
+
+		// boxes scattered over a large area, with 1M random candidate pairs between them
+		const size_t boxCount = 10000;
+		const size_t pairCount = 1000000;
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> position(-5000, 5000), size(1, 200);
+
+		EntityManager entities;
+		std::vector<Entity*> boxed;
+		BoxArrays boxes;
+		for (size_t i = 0; i < boxCount; ++i)
+		{
+			Entity& e = entities.addEntity("Tile");
+			Vec2 center(position(rng), position(rng));
+			e.add<CTransform>(center);
+			e.add<CBoundingBox>(center, Vec2(0, 0), Vec2(size(rng), size(rng)));
+			boxed.push_back(&e);
+			boxes.push(center, std::as_const(e).get<CBoundingBox>().halfSize);
+		}
+		entities.update();
+
+		std::vector<BoxPair> pairs(pairCount);
+		for (BoxPair& pair : pairs)
+		{
+			pair.a = rng() % boxCount;
+			pair.b = rng() % boxCount;
+		}
+
+		std::cout << "overlaps: " << pairCount << " candidate pairs between " << boxCount << " boxes\n";
+
+		std::vector<float> expectedX(pairCount), expectedY(pairCount);
+		double single = bestOf(3, [&]
+		{
+			for (size_t i = 0; i < pairCount; ++i)
+			{
+				Vec2 overlap = Physics::GetOverlap(*boxed[pairs[i].a], *boxed[pairs[i].b]);
+				expectedX[i] = overlap.x;
+				expectedY[i] = overlap.y;
+			}
+		});
+		std::cout << "  GetOverlap per pair: " << single << " ms, " << pairCount / single / 1000 << " M pairs/s\n";
+
+		const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX };
+		const char* levelNames[] = { "scalar", "SSE2", "AVX" };
+		std::vector<float> overlapX(pairCount), overlapY(pairCount);
+		SimdLevel startLevel = Physics::GetSimdLevel();
+		for (size_t l = 0; l < 3; ++l)
+		{
+			Physics::SetSimdLevel(levels[l]);
+			if (Physics::GetSimdLevel() != levels[l]) { std::cout << "  " << levelNames[l] << ": not supported by this CPU\n"; continue; }
+
+			double batch = bestOf(10, [&] { Physics::GetOverlaps(boxes, pairs.data(), pairCount, overlapX.data(), overlapY.data()); });
+			bool identical = std::memcmp(overlapX.data(), expectedX.data(), pairCount * sizeof(float)) == 0 &&
+				std::memcmp(overlapY.data(), expectedY.data(), pairCount * sizeof(float)) == 0;
+			std::cout << "  batch " << levelNames[l] << ": " << batch << " ms, " << pairCount / batch / 1000 << " M pairs/s, "
+				<< (identical ? "identical to GetOverlap" : "DIFFERS from GetOverlap") << "\n";
+		}
+		Physics::SetSimdLevel(startLevel);
+	}
+
+	void slicing()
+	{
+		std::cout << std::fixed << std::setprecision(3);
+
+		// an 8192x8192 sheet of 64 pixel tiles where every other tile has a single opaque pixel, placed
+		// differently in each so a scan can't stop early at the same spot every time
+		const unsigned int side = 8192;
+		const int tileSize = 64;
+		const int tilesPerSide = (int)side / tileSize;
+		sf::Image sheet;
+		sheet.create(side, side, sf::Color::Transparent);
+		size_t filled = 0;
+		for (int c = 0; c < tilesPerSide; ++c)
+		{
+			for (int r = 0; r < tilesPerSide; ++r)
+			{
+				if ((c * 7 + r * 3) % 2 != 0) { continue; }
+				sheet.setPixel(c * tileSize + (c * 5 + r) % tileSize, r * tileSize + (r * 11 + c) % tileSize, sf::Color::White);
+				++filled;
+			}
+		}
+		std::cout << "slicing: " << side << "x" << side << " sheet, " << tilesPerSide * tilesPerSide << " tiles of which " << filled << " filled\n";
+
+		// how sheets were cut before: copy each tile out, then read it a pixel at a time
+		size_t copiedTiles = 0;
+		double copied = bestOf(2, [&]
+		{
+			copiedTiles = 0;
+			sf::Image tile;
+			tile.create(tileSize, tileSize);
+			for (int c = 0; c < tilesPerSide; ++c)
+			{
+				for (int r = 0; r < tilesPerSide; ++r)
+				{
+					tile.copy(sheet, 0, 0, sf::IntRect(c * tileSize, r * tileSize, tileSize, tileSize));
+					bool empty = true;
+					for (int x = 0; x < tileSize && empty; ++x)
+					{
+						for (int y = 0; y < tileSize; ++y)
+						{
+							if (tile.getPixel(x, y).a != 0) { empty = false; break; }
+						}
+					}
+					if (!empty) { ++copiedTiles; }
+				}
+			}
+		});
+		std::cout << "  copy and getPixel per tile: " << copied << " ms, " << copiedTiles << " tiles\n";
+
+		std::vector<sf::IntRect> tiles;
+		double sliced = bestOf(5, [&]
+		{
+			tiles.clear();
+			Assets::sliceTilesheet(sheet, Vec2((float)tileSize, (float)tileSize), tiles);
+		});
+		std::cout << "  sliceTilesheet: " << sliced << " ms, " << tiles.size() << " tiles\n";
+	}
+
+	void levelLoading()
+	{
+		std::cout << std::fixed << std::setprecision(3);
+
+		// a 1M line level in the map_home.txt format, using the names that level uses
+		const size_t lineCount = 1000000;
+		const char* const* names = MapAnimationNames;
+		const size_t nameCount = MapAnimationNameCount;
+
+		std::string level;
+		level.reserve(lineCount * 48);
+		for (size_t i = 0; i < lineCount; ++i)
+		{
+			const std::string name = names[(i * 2654435761u >> 8) % nameCount];
+			std::string cell = std::to_string(i % 1000) + " " + std::to_string(i / 1000);
+			if (i % 5 == 0) { level += "Tile " + name + " " + cell + " 0 0 0 0 64 64 1 1\n"; }
+			else { level += "Decoration " + name + " " + cell + "\n"; }
+		}
+
+		// the tables the two ways resolve names with: the old name to Animation map, the name to id table now
+		std::map<std::string, OldAnimation> byName;
+		std::unordered_map<std::string, AnimationId> ids;
+		for (size_t i = 0; i < nameCount; ++i)
+		{
+			byName[names[i]].name = names[i];
+			ids[names[i]] = AnimationId{ (uint32_t)i };
+		}
+
+		std::cout << "levelLoading: " << lineCount << " lines, " << level.size() / (1024 * 1024) << " MiB\n";
+
+		// before: the old loader, a shared_ptr to an entity carrying every component per line, the Animation
+		// copied out of the name map into it, and the entity listed by tag when the manager updates
+		size_t oldBytes = 0;
+		double before = bestOf(2, [&]
+		{
+			typedef std::vector<std::shared_ptr<InlineEntity>> OldEntityVec;
+			OldEntityVec entities, toAdd;
+			std::map<std::string, OldEntityVec> byTag;
+			size_t totalEntities = 0;
+			std::istringstream file(level);
+			std::string type, name;
+			while (file >> type)
+			{
+				auto entity = std::make_shared<InlineEntity>();
+				entity->id = totalEntities++;
+				entity->tag = type;
+				toAdd.push_back(entity);
+				int gridX, gridY;
+				file >> name >> gridX >> gridY;
+				auto it = byName.find(name);
+				entity->animation.animation = it != byName.end() ? it->second : OldAnimation();
+				entity->animation.has = true;
+				entity->transform = CTransform(Vec2(gridX * 64.0f + 32, gridY * 64.0f + 32));
+				entity->transform.has = true;
+				if (type == "Tile")
+				{
+					float bbPosX, bbPosY, bbOffsetX, bbOffsetY, bbWidth, bbHeight;
+					bool blockMove, blockVision;
+					file >> bbPosX >> bbPosY >> bbOffsetX >> bbOffsetY >> bbWidth >> bbHeight >> blockMove >> blockVision;
+					entity->boundingBox = CBoundingBox(Vec2(bbPosX, bbPosY), Vec2(bbOffsetX, bbOffsetY), Vec2(bbWidth, bbHeight), blockMove, blockVision);
+					entity->boundingBox.has = true;
+				}
+			}
+			for (auto& e : toAdd)
+			{
+				entities.push_back(e);
+				byTag[e->tag].push_back(e);
+			}
+			toAdd.clear();
+			oldBytes = 0;
+			for (auto& e : entities) { oldBytes += sizeof(InlineEntity) + heapBytes(e->tag) + heapBytes(e->animation.animation.name); }
+			g_sink = (double)entities.size();
+		});
+
+		// after: the home map's loader now, the name looked up once per line and only the id kept
+		double after = bestOf(2, [&]
+		{
+			EntityManager entities;
+			std::istringstream file(level);
+			std::string type, name;
+			while (file >> type)
+			{
+				Entity& entity = entities.addEntity(type);
+				int gridX, gridY;
+				file >> name >> gridX >> gridY;
+				auto it = ids.find(name);
+				entity.add<CAnimation>(it != ids.end() ? it->second : AnimationId(), 0, true);
+				entity.add<CTransform>(Vec2(gridX * 64.0f + 32, gridY * 64.0f + 32));
+				if (type == "Tile")
+				{
+					float bbPosX, bbPosY, bbOffsetX, bbOffsetY, bbWidth, bbHeight;
+					bool blockMove, blockVision;
+					file >> bbPosX >> bbPosY >> bbOffsetX >> bbOffsetY >> bbWidth >> bbHeight >> blockMove >> blockVision;
+					entity.add<CBoundingBox>(Vec2(bbPosX, bbPosY), Vec2(bbOffsetX, bbOffsetY), Vec2(bbWidth, bbHeight), blockMove, blockVision);
+				}
+			}
+			entities.update();
+			g_sink = (double)entities.getEntities().size();
+		});
+
+		std::cout << "  old inline entities, Animation copies: " << before << " ms, " << oldBytes / (1024 * 1024) << " MiB of entities\n";
+		std::cout << "  pooled entities, CAnimation ids:       " << after << " ms, " << lineCount * sizeof(CAnimation) / (1024 * 1024) << " MiB of animation components\n";
+
+		// resolving names during play, as getAnimation(name) did on every call, against indexing by id
+		const size_t lookups = 1000000;
+		std::vector<Animation> table(nameCount);
+		std::vector<std::string> keys(names, names + nameCount);
+		double nameLookups = bestOf(5, [&]
+		{
+			size_t frames = 0;
+			for (size_t i = 0; i < lookups; ++i) { frames += byName.find(keys[i % nameCount])->second.frameCount; }
+			g_sink = (double)frames;
+		});
+		double idLookups = bestOf(5, [&]
+		{
+			size_t frames = 0;
+			for (size_t i = 0; i < lookups; ++i) { frames += table[i % nameCount].getFrameCount(); }
+			g_sink = (double)frames;
+		});
+		std::cout << "  " << lookups << " lookups: by name " << nameLookups << " ms, by id " << idLookups << " ms\n";
+	}
+
+	const Entry Entries[] =
+	{
+		{ "components", &components },
+		{ "views", &views },
+		{ "tileGrid", &tileGrid },
+		{ "hierarchicalPaths", &hierarchicalPaths },
+		{ "overlaps", &overlaps },
+		{ "slicing", &slicing },
+		{ "levelLoading", &levelLoading },
+	};
+
+	const size_t EntryCount = sizeof(Entries) / sizeof(Entries[0]);
+}
+
+bool Benchmark::run(const std::string& name)
+{
+	bool found = false;
+	for (size_t i = 0; i < EntryCount; ++i)
+	{
+		if (name != "all" && name != Entries[i].name) { continue; }
+		Entries[i].run();
+		std::cout << std::flush;
+		found = true;
+	}
+	return found;
+}
+
+std::string Benchmark::names()
+{
+	std::string names;
+	for (size_t i = 0; i < EntryCount; ++i)
+	{
+		if (i > 0) { names += "|"; }
+		names += Entries[i].name;
+	}
+	return names;
+}
\ No newline at end of file
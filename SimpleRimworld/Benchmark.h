@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+// Synthetic workloads for the engine's data structures, run with SimpleRimworld --bench <name>. Each one
+// builds what it measures itself, times it and prints the results. None of them need a window.
+class Benchmark
+{
+public:
+
+	// Runs the named benchmark, or every one for "all". Returns false for an unknown name.
+	static bool run(const std::string& name);
+
+	// the benchmark names separated by '|', for the usage line
+	static std::string names();
+};
\ No newline at end of file
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Components.h"
+
+#include <tuple>
+#include <cassert>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+// A sparse set that packs every component of a single type into one contiguous array.
+// The sparse array maps an entity index to the slot its component lives in, so a system that
+// only needs one component type walks a dense array instead of dragging every component of
+// every entity through the cache.
+template <typename T>
+class ComponentPool
+{
+	static constexpr size_t npos = (size_t)-1;
+
+	std::vector<T>      m_dense;   // the components of this type packed together
+	std::vector<size_t> m_owners;  // the entity index owning the component at the same dense index
+	std::vector<size_t> m_sparse;  // entity index -> dense index, npos when the entity has no slot
+
+public:
+
+	bool contains(size_t entity) const
+	{
+		return entity < m_sparse.size() && m_sparse[entity] != npos;
+	}
+
+	// The entity's component, which it must have. Use find() when it may not.
+	//
+	// The reference points into the packed array, so it is only good until the next component of this type
+	// is added to any entity, which can move the array, or until the component is removed.
+	T& get(size_t entity)
+	{
+		assert(contains(entity));
+		return m_dense[m_sparse[entity]];
+	}
+
+	T* find(size_t entity)
+	{
+		return contains(entity) ? &m_dense[m_sparse[entity]] : nullptr;
+	}
+
+	const T* find(size_t entity) const
+	{
+		return contains(entity) ? &m_dense[m_sparse[entity]] : nullptr;
+	}
+
+	T& emplace(size_t entity, T&& component)
+	{
+		if (contains(entity))
+		{
+			T& existing = m_dense[m_sparse[entity]];
+			existing = std::move(component);
+			return existing;
+		}
+
+		if (entity >= m_sparse.size()) { m_sparse.resize(entity + 1, npos); }
+		m_sparse[entity] = m_dense.size();
+		m_owners.push_back(entity);
+		m_dense.push_back(std::move(component));
+		return m_dense.back();
+	}
+
+	void remove(size_t entity)
+	{
+		if (!contains(entity)) { return; }
+
+		// swap the last component into the removed slot so the array stays packed
+		size_t index = m_sparse[entity];
+		size_t last = m_dense.size() - 1;
+		if (index != last)
+		{
+			m_dense[index] = std::move(m_dense[last]);
+			m_owners[index] = m_owners[last];
+			m_sparse[m_owners[index]] = index;
+		}
+		m_dense.pop_back();
+		m_owners.pop_back();
+		m_sparse[entity] = npos;
+	}
+
+	size_t size() const
+	{
+		return m_dense.size();
+	}
+
+	const std::vector<size_t>& owners() const
+	{
+		return m_owners;
+	}
+
+	// The entity index that owns the component at the given dense index.
+	size_t owner(size_t denseIndex) const
+	{
+		return m_owners[denseIndex];
+	}
+
+	T& at(size_t denseIndex)
+	{
+		return m_dense[denseIndex];
+	}
+
+	const T& at(size_t denseIndex) const
+	{
+		return m_dense[denseIndex];
+	}
+
+	// Bytes reserved by the pool including the sparse lookup table.
+	size_t memoryUsage() const
+	{
+		return m_dense.capacity() * sizeof(T) + (m_owners.capacity() + m_sparse.capacity()) * sizeof(size_t);
+	}
+};
+
+typedef std::tuple <
+	ComponentPool<CTransform>,
+	ComponentPool<CInput>,
+	ComponentPool<CLifespan>,
+	ComponentPool<CDamage>,
+	ComponentPool<CInvincibility>,
+	ComponentPool<CHealth>,
+	ComponentPool<CAnimation>,
+	ComponentPool<CState>,
+	ComponentPool<CBoundingBox>,
+	ComponentPool<CFollowPlayer>,
+	ComponentPool<CPatrol>,
+	ComponentPool<CDraggable>
+> ComponentPoolTuple;
+
+// One bit per component type, set on an entity when it has that component.
+typedef uint32_t ComponentMask;
+
+static_assert(std::tuple_size_v<ComponentPoolTuple> <= sizeof(ComponentMask) * 8, "ComponentMask has too few bits for every component type");
+
+// Position of ComponentPool<T> in the pool tuple, used as the component's bit in a ComponentMask.
+template <typename T, typename Tuple>
+struct ComponentIndex;
+
+template <typename T, typename... Pools>
+struct ComponentIndex<T, std::tuple<Pools...>>
+{
+	static constexpr size_t find()
+	{
+		size_t index = 0;
+		bool found = ((std::is_same_v<ComponentPool<T>, Pools> ? true : (++index, false)) || ...);
+		return found ? index : sizeof...(Pools);
+	}
+
+	static constexpr size_t value = find();
+	static_assert(value < sizeof...(Pools), "Component type is not in ComponentPoolTuple");
+};
+
+// Owns one ComponentPool per component type. The EntityManager holds the storage and every
+// Entity it creates keeps a pointer to it so the Entity interface can stay the same.
+class ComponentStorage
+{
+	ComponentPoolTuple m_pools;
+
+public:
+
+	template <typename... Ts>
+	static constexpr ComponentMask mask()
+	{
+		return ((ComponentMask(1) << ComponentIndex<Ts, ComponentPoolTuple>::value) | ... | 0);
+	}
+
+	template <typename T>
+	ComponentPool<T>& pool()
+	{
+		return std::get<ComponentPool<T>>(m_pools);
+	}
+
+	template <typename T>
+	const ComponentPool<T>& pool() const
+	{
+		return std::get<ComponentPool<T>>(m_pools);
+	}
+
+	void removeAll(size_t entity)
+	{
+		std::apply([entity](auto&... pools) { (pools.remove(entity), ...); }, m_pools);
+	}
+
+	size_t memoryUsage() const
+	{
+		return std::apply([](const auto&... pools) { return (pools.memoryUsage() + ...); }, m_pools);
+	}
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Animation.h"
+#include "AssetId.h"
 
 class Component
 {
@@ -20,7 +21,7 @@ public:
 
 	CTransform() {}
 	CTransform(const Vec2& p)
-		: pos(p) {}
+		: pos(p), prevPos(p) {}
 	CTransform(const Vec2& p, const Vec2& sp, const Vec2& sc, float a)
 		: pos(p), prevPos(p), velocity(sp), scale(sc), angle(a) {}
 };
@@ -79,11 +80,12 @@ public:
 class CAnimation : public Component
 {
 public:
-	Animation animation;
+	AnimationId id;              // the clip, shared through Assets
+	uint32_t startFrame = 0;     // the scene frame the clip started playing on
 	bool repeat = false;
 	CAnimation() {}
-	CAnimation(const Animation& ani, bool r)
-		: animation(ani), repeat(r) {}
+	CAnimation(AnimationId i, size_t start, bool r)
+		: id(i), startFrame((uint32_t)start), repeat(r) {}
 };
 
 class CState : public Component
@@ -136,4 +138,4 @@ class CDraggable : public Component
 public:
 	bool dragging = false;
 	CDraggable() {}
-};
+};
\ No newline at end of file
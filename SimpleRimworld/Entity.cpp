@@ -1,15 +1,22 @@
 #include "Entity.h"
+#include "EntityManager.h"
 
-Entity::Entity(const size_t id, const std::string& tag)
+Entity::Entity(const size_t id, EntityManager* manager, ComponentStorage* components)
 	: m_id(id)
-	, m_tag(tag)
+	, m_manager(manager)
+	, m_components(components)
 {
 	
 }
 
 void Entity::destroy()
 {
-	m_active = false;
+	// only queue the entity once so the EntityManager never removes it twice
+	if (m_active)
+	{
+		m_active = false;
+		m_manager->m_entitiesToRemove.push_back(this);
+	}
 }
 
 const size_t Entity::id() const
@@ -17,6 +24,11 @@ const size_t Entity::id() const
 	return m_id;
 }
 
+EntityHandle Entity::handle() const
+{
+	return { (uint32_t)m_id, m_generation };
+}
+
 bool Entity::isActive() const
 {
 	return m_active;
@@ -24,5 +36,10 @@ bool Entity::isActive() const
 
 const std::string& Entity::tag() const
 {
-	return m_tag;
+	return *m_tag;
+}
+
+TagId Entity::tagId() const
+{
+	return m_tagId;
 }
\ No newline at end of file
@@ -1,75 +1,94 @@
 #pragma once
 
-#include "Components.h"
+#include "ComponentPool.h"
 
-#include <tuple>
 #include <string>
+#include <cstdint>
 
 class EntityManager;
 
-typedef std::tuple <
-	CTransform,
-	CInput,
-	CLifespan,
-	CDamage,
-	CInvincibility,
-	CHealth,
-	CAnimation,
-	CState,
-	CBoundingBox,
-	CFollowPlayer,
-	CPatrol,
-	CDraggable
-> ComponentTuple;
+// Tags are interned by the EntityManager to small integers when they are first registered.
+typedef size_t TagId;
+
+// A lightweight reference to an entity: the slot it lives in and the generation of that slot.
+// The generation is bumped every time a slot is recycled so a handle to a removed entity can be
+// detected as stale instead of silently pointing at whatever entity reused the slot.
+struct EntityHandle
+{
+	static constexpr uint32_t invalidIndex = UINT32_MAX;
+
+	uint32_t index		= invalidIndex;
+	uint32_t generation = 0;
+
+	bool isValid() const { return index != invalidIndex; }
+	bool operator == (const EntityHandle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+	bool operator != (const EntityHandle& rhs) const { return !(*this == rhs); }
+};
 
 class Entity
 {
 	friend class EntityManager;
+	template <typename... Ts> friend class EntityView;
 
-	bool           m_active = true;
-	std::string    m_tag = "default";
-	size_t		   m_id = 0;
-	ComponentTuple m_components;
+	bool               m_active = true;
+	const std::string* m_tag = nullptr;      // interned name owned by the EntityManager's tag table
+	TagId              m_tagId = 0;
+	size_t             m_id = 0;             // index of the slot in the EntityManager, reused once the entity is removed
+	uint32_t           m_generation = 0;     // bumped by the EntityManager every time the slot is released
+	size_t             m_entitiesIndex = 0;  // position in the EntityManager's entity vector, used for swap-and-pop removal
+	size_t             m_tagIndex = 0;       // position in the vector of entities sharing this tag
+	ComponentMask      m_signature = 0;      // which components the entity has, checked by has() and EntityManager::view()
+	EntityManager*     m_manager = nullptr;
+	ComponentStorage*  m_components = nullptr;  // owned by the EntityManager that created this entity
 
-	Entity(const size_t id, const std::string& tag);
+	Entity(const size_t id, EntityManager* manager, ComponentStorage* components);
 
 public:
 
 	void               destroy();
 	const size_t       id() const;
+	EntityHandle       handle() const;
 	bool               isActive() const;
 	const std::string& tag() const;
+	TagId              tagId() const;
 
 	template <typename T>
 	bool has() const
 	{
-		return get<T>().has;
+		return (m_signature & ComponentStorage::mask<T>()) != 0;
 	}
 
 	template <typename T, typename... TArgs>
 	T& add(TArgs&&... mArgs)
 	{
-		auto& component = get<T>();
-		component = T(std::forward<TArgs>(mArgs)...);
+		auto& component = m_components->pool<T>().emplace(m_id, T(std::forward<TArgs>(mArgs)...));
 		component.has = true;
+		m_signature |= ComponentStorage::mask<T>();
 		return component;
 	}
 
+	// The entity has to have the component, check with has() first if it might not. The reference is only
+	// good until another component of the same type is added to any entity (see ComponentPool::get).
 	template <typename T>
 	T& get()
 	{
-		return std::get<T>(m_components);
+		return m_components->pool<T>().get(m_id);
 	}
 
+	// For reading a component the entity may not have: a missing one comes back as a default component
+	// (has == false) without being added.
 	template <typename T>
 	const T& get() const
 	{
-		return std::get<T>(m_components);
+		static const T empty;
+		const T* component = m_components->pool<T>().find(m_id);
+		return component != nullptr ? *component : empty;
 	}
 
 	template <typename T>
 	void remove()
 	{
-		get<T>() = T();
+		m_components->pool<T>().remove(m_id);
+		m_signature &= ~ComponentStorage::mask<T>();
 	}
-};
+};
\ No newline at end of file
@@ -9,46 +9,143 @@ void EntityManager::update()
 {
 	for (auto& e : m_entitiesToAdd)
 	{
+		e->m_entitiesIndex = m_entities.size();
 		m_entities.push_back(e);
-		m_entityMap[e.get()->m_tag].push_back(e);
+
+		auto& tagVec = m_entitiesByTag[e->m_tagId];
+		e->m_tagIndex = tagVec.size();
+		tagVec.push_back(e);
 	}
 	m_entitiesToAdd.clear();
 
-	removeDeadEntities(m_entities);
+	if (m_entities.size() > m_peakEntities) { m_peakEntities = m_entities.size(); }
+
+	// destroy() queues entities here, so frames where nothing died skip the sweep entirely
+	if (m_entitiesToRemove.empty()) { return; }
 
-	for (auto& [tag, entityVec] : m_entityMap)
+	for (auto& e : m_entitiesToRemove)
 	{
-		removeDeadEntities(entityVec);
+		removeEntity(*e);
 	}
+	m_entitiesToRemove.clear();
 }
 
-void EntityManager::removeDeadEntities(EntityVec& vec)
+void EntityManager::removeEntity(Entity& entity)
 {
-	// erase takes a beginning iterator and an ending iterator. The remove_if function returns
-	// an iterator of the element right before the element to be removed. Lambda function is used
-	// to look at the Entity isActive boolean variable.
-	vec.erase(std::remove_if(vec.begin(), vec.end(),
-		[](std::shared_ptr<Entity> object) {return !(object->isActive()); }), vec.end());
+	// Move the last entity of each vector into the removed entity's position so removal doesn't
+	// shift the rest of the vector. Iteration order isn't preserved but nothing depends on it.
+	Entity* last = m_entities.back();
+	m_entities[entity.m_entitiesIndex] = last;
+	last->m_entitiesIndex = entity.m_entitiesIndex;
+	m_entities.pop_back();
+
+	auto& tagVec = m_entitiesByTag[entity.m_tagId];
+	last = tagVec.back();
+	tagVec[entity.m_tagIndex] = last;
+	last->m_tagIndex = entity.m_tagIndex;
+	tagVec.pop_back();
+
+	releaseSlot(entity);
 }
 
-std::shared_ptr<Entity> EntityManager::addEntity(const std::string& tag)
+void EntityManager::releaseSlot(Entity& entity)
 {
-	auto entity = std::shared_ptr<Entity>(new Entity(m_totalEntities++, tag));
-	m_entitiesToAdd.push_back(entity);
+	m_components.removeAll(entity.m_id);
+	entity.m_signature = 0;
+
+	// bumping the generation invalidates every handle that still refers to this slot
+	entity.m_generation++;
+	m_slots.release(entity.m_id);
+}
+
+TagId EntityManager::registerTag(const std::string& tag)
+{
+	auto it = m_tagIds.find(tag);
+	if (it != m_tagIds.end()) { return it->second; }
+
+	TagId id = m_tagNames.size();
+	m_tagNames.push_back(tag);
+	m_tagIds[tag] = id;
+	m_entitiesByTag.emplace_back();
+	return id;
+}
+
+const std::string& EntityManager::tagName(TagId tag) const
+{
+	return m_tagNames[tag];
+}
+
+Entity& EntityManager::addEntity(const std::string& tag)
+{
+	return addEntity(registerTag(tag));
+}
+
+Entity& EntityManager::addEntity(TagId tag)
+{
+	// a reused slot keeps its generation so handles to the previous entity stay stale
+	size_t index = m_slots.nextIndex();
+	uint32_t generation = index < m_slots.size() ? m_slots[index].m_generation : 0;
+
+	Entity& entity = m_slots.acquire(Entity(index, this, &m_components));
+	entity.m_generation = generation;
+	entity.m_tagId = tag;
+	entity.m_tag = &m_tagNames[tag];
+
+	m_entitiesToAdd.push_back(&entity);
 	return entity;
 }
 
+Entity* EntityManager::getEntity(EntityHandle handle)
+{
+	if (!isValid(handle)) { return nullptr; }
+	return &m_slots[handle.index];
+}
+
+bool EntityManager::isValid(EntityHandle handle) const
+{
+	if (handle.index >= m_slots.size()) { return false; }
+
+	const Entity& entity = m_slots[handle.index];
+	return entity.m_generation == handle.generation && entity.isActive();
+}
+
 const EntityVec& EntityManager::getEntities()
 {
 	return m_entities;
 }
 
+const EntityVec& EntityManager::getEntities(TagId tag)
+{
+	return m_entitiesByTag[tag];
+}
+
 const EntityVec& EntityManager::getEntities(const std::string& tag)
 {
-	return m_entityMap[tag];
+	// look the tag up without registering it so unknown tags don't grow the tag table
+	static const EntityVec empty;
+	auto it = m_tagIds.find(tag);
+	return it != m_tagIds.end() ? m_entitiesByTag[it->second] : empty;
+}
+
+FrameArena& EntityManager::frameArena()
+{
+	return m_frameArena;
 }
 
-const std::map<std::string, EntityVec>& EntityManager::getEntityMap()
+EntityMemoryStats EntityManager::memoryStats() const
 {
-	return m_entityMap;
+	EntityMemoryStats stats;
+	stats.liveEntities = m_entities.size();
+	stats.peakEntities = m_peakEntities > m_entities.size() ? m_peakEntities : m_entities.size();
+	stats.slots = m_slots.size();
+	stats.freeSlots = m_slots.freeCount();
+	stats.slotReuses = m_slots.reuseCount();
+	stats.entityBytes = m_slots.memoryUsage() +
+		(m_entities.capacity() + m_entitiesToAdd.capacity() + m_entitiesToRemove.capacity()) * sizeof(Entity*);
+	for (auto& tagVec : m_entitiesByTag) { stats.entityBytes += tagVec.capacity() * sizeof(Entity*); }
+	stats.componentBytes = m_components.memoryUsage();
+	stats.arenaBytes = m_frameArena.bytesUsed();
+	stats.arenaPeakBytes = m_frameArena.peakBytes();
+	stats.arenaCapacity = m_frameArena.capacity();
+	return stats;
 }
\ No newline at end of file
@@ -1,29 +1,197 @@
 #pragma once
 
-#include "Entity.h"
+#include "EntityPool.h"
+#include "FrameArena.h"
 #include <vector>
-#include <map>
+#include <deque>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
 
-typedef std::vector<std::shared_ptr<Entity>> EntityVec;
-typedef std::map<std::string, EntityVec>	 EntityMap;
+typedef std::vector<Entity*> EntityVec;
+
+// Counters for the entity and component memory owned by an EntityManager, shown in the debug GUI.
+struct EntityMemoryStats
+{
+	size_t liveEntities   = 0;
+	size_t peakEntities   = 0;
+	size_t slots          = 0;  // entity slots created, live or free
+	size_t freeSlots      = 0;
+	size_t slotReuses     = 0;
+	size_t entityBytes    = 0;
+	size_t componentBytes = 0;
+	size_t arenaBytes     = 0;  // frame arena bytes used so far this frame
+	size_t arenaPeakBytes = 0;
+	size_t arenaCapacity  = 0;
+};
+
+// Iterates the entities that have every component in Ts. Only the owners of the smallest pool in the
+// set are visited, so the cost follows the number of entities holding the rarest component rather than
+// the total number of entities.
+//
+// each() is the fast way through: it walks the smallest pool's components and owners side by side and
+// only looks the other components up. Iterating with begin() and end() checks each owner's signature and
+// leaves fetching the components to the caller.
+template <typename... Ts>
+class EntityView
+{
+	EntityPool&				   m_slots;
+	ComponentStorage&		   m_storage;
+	const std::vector<size_t>* m_owners = nullptr;  // owners of the smallest pool in the view
+	size_t					   m_lead = 0;          // position in Ts of the smallest pool
+	ComponentMask			   m_mask = ComponentStorage::mask<Ts...>();
+
+	// The component of type T of the entity at the given dense index of the lead pool, nullptr if it has none
+	template <typename T, typename Lead>
+	T* component(ComponentPool<Lead>& lead, size_t denseIndex, size_t owner) const
+	{
+		if constexpr (std::is_same_v<T, Lead>) { return &lead.at(denseIndex); }
+		else { return m_storage.pool<T>().find(owner); }
+	}
+
+	template <typename Lead, typename Func>
+	void eachFrom(Func& func) const
+	{
+		// Entities added while iterating are not visited and removing components while iterating can shrink
+		// the pool, so stop at whichever comes first.
+		ComponentPool<Lead>& lead = m_storage.pool<Lead>();
+		const std::vector<size_t>& owners = lead.owners();
+		size_t count = lead.size();
+		for (size_t i = 0; i < count && i < lead.size(); ++i)
+		{
+			size_t owner = owners[i];
+			std::tuple<Ts*...> components(component<Ts>(lead, i, owner)...);
+			if (((std::get<Ts*>(components) == nullptr) || ...)) { continue; }
+			func(m_slots[owner], *std::get<Ts*>(components)...);
+		}
+	}
+
+public:
+
+	class Iterator
+	{
+		const EntityView* m_view = nullptr;
+		size_t			  m_index = 0;
+
+		// move forward to the next owner that has every component of the view
+		void skip()
+		{
+			while (m_index < m_view->m_owners->size())
+			{
+				const Entity& e = m_view->m_slots[(*m_view->m_owners)[m_index]];
+				if ((e.m_signature & m_view->m_mask) == m_view->m_mask) { return; }
+				++m_index;
+			}
+		}
+
+	public:
+
+		Iterator(const EntityView* view, size_t index)
+			: m_view(view)
+			, m_index(index)
+		{
+			skip();
+		}
+
+		Entity& operator*() const { return m_view->m_slots[(*m_view->m_owners)[m_index]]; }
+		Iterator& operator++() { ++m_index; skip(); return *this; }
+
+		// Entities added while iterating are not visited and removing components while iterating can shrink
+		// the pool, so stop at whichever comes first.
+		bool operator != (const Iterator& rhs) const
+		{
+			return m_index < rhs.m_index && m_index < m_view->m_owners->size();
+		}
+	};
+
+	EntityView(EntityPool& slots, ComponentStorage& storage)
+		: m_slots(slots)
+		, m_storage(storage)
+	{
+		size_t smallest = (size_t)-1;
+		size_t position = 0;
+		auto consider = [&](auto& pool)
+		{
+			if (pool.size() < smallest)
+			{
+				smallest = pool.size();
+				m_owners = &pool.owners();
+				m_lead = position;
+			}
+			++position;
+		};
+		(consider(storage.pool<Ts>()), ...);
+	}
+
+	Iterator begin() const { return Iterator(this, 0); }
+	Iterator end() const { return Iterator(this, m_owners->size()); }
+
+	// Calls func(entity, components...) for every entity in the view.
+	template <typename Func>
+	void each(Func func) const
+	{
+		size_t position = 0;
+		((position++ == m_lead ? eachFrom<Ts>(func) : void()), ...);
+	}
+};
 
 class EntityManager
 {
-	EntityVec m_entities;
-	EntityVec m_entitiesToAdd;
-	EntityMap m_entityMap;
-	size_t	  m_totalEntities = 0;
+	friend class Entity;
+
+	EntityPool                             m_slots;             // every entity lives here and never moves in memory
+	EntityVec                              m_entities;
+	EntityVec                              m_entitiesToAdd;
+	EntityVec                              m_entitiesToRemove;  // filled by Entity::destroy()
+	std::vector<EntityVec>                 m_entitiesByTag;     // indexed by TagId
+	std::deque<std::string>                m_tagNames;          // indexed by TagId, a deque so entities can point at the names
+	std::unordered_map<std::string, TagId> m_tagIds;
+	ComponentStorage                       m_components;
+	FrameArena                             m_frameArena;
+	size_t                                 m_peakEntities = 0;
 
-	void removeDeadEntities(EntityVec& vec);
+	void removeEntity(Entity& entity);
+	void releaseSlot(Entity& entity);
 
 public:
 	EntityManager();
 
 	void update();
 
-	std::shared_ptr<Entity> addEntity(const std::string& tag);
+	// Interns a tag name to a small integer id, returning the existing id if it was already registered.
+	TagId registerTag(const std::string& tag);
+	const std::string& tagName(TagId tag) const;
+
+	Entity& addEntity(const std::string& tag);
+	Entity& addEntity(TagId tag);
+
+	// Resolves a handle to its entity. Returns nullptr if the entity has been destroyed
+	// or its slot has been given to a new entity since the handle was taken.
+	Entity* getEntity(EntityHandle handle);
+	bool isValid(EntityHandle handle) const;
 
 	const EntityVec& getEntities();
+	const EntityVec& getEntities(TagId tag);
 	const EntityVec& getEntities(const std::string& tag);
-	const std::map<std::string, EntityVec>& getEntityMap();
+
+	// Entities that have every component in Ts, e.g. view<CTransform, CBoundingBox>().
+	template <typename... Ts>
+	EntityView<Ts...> view()
+	{
+		static_assert(sizeof...(Ts) > 0, "view needs at least one component type");
+		return EntityView<Ts...>(m_slots, m_components);
+	}
+
+	// Direct access to the packed array of a single component type so systems can stream
+	// through only the components they use. Entries can have has == false so check it.
+	template <typename T>
+	ComponentPool<T>& getComponents()
+	{
+		return m_components.pool<T>();
+	}
+
+	// Scratch memory for the current frame, released by Scene::beginFrame() when the next frame starts.
+	FrameArena& frameArena();
+
+	EntityMemoryStats memoryStats() const;
 };
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "EntityPool.h"
+
+EntityPool::EntityPool()
+{
+
+}
+
+Entity& EntityPool::acquire(Entity&& entity)
+{
+	if (!m_freeSlots.empty())
+	{
+		size_t index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		++m_reuses;
+
+		Entity& slot = (*this)[index];
+		slot = std::move(entity);
+		return slot;
+	}
+
+	if (m_size % ChunkSize == 0)
+	{
+		m_chunks.emplace_back();
+		m_chunks.back().reserve(ChunkSize);
+	}
+
+	++m_size;
+	m_chunks.back().push_back(std::move(entity));
+	return m_chunks.back().back();
+}
+
+void EntityPool::release(size_t index)
+{
+	m_freeSlots.push_back(index);
+}
+
+size_t EntityPool::nextIndex() const
+{
+	return m_freeSlots.empty() ? m_size : m_freeSlots.back();
+}
+
+Entity& EntityPool::operator [] (size_t index)
+{
+	return m_chunks[index / ChunkSize][index % ChunkSize];
+}
+
+const Entity& EntityPool::operator [] (size_t index) const
+{
+	return m_chunks[index / ChunkSize][index % ChunkSize];
+}
+
+size_t EntityPool::size() const
+{
+	return m_size;
+}
+
+size_t EntityPool::freeCount() const
+{
+	return m_freeSlots.size();
+}
+
+size_t EntityPool::reuseCount() const
+{
+	return m_reuses;
+}
+
+size_t EntityPool::memoryUsage() const
+{
+	return m_chunks.size() * ChunkSize * sizeof(Entity) + m_freeSlots.capacity() * sizeof(size_t);
+}
\ No newline at end of file
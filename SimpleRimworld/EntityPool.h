@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Entity.h"
+
+#include <vector>
+
+// Owns the memory every Entity lives in. Entities are stored in fixed size chunks so an entity never
+// moves once it is created and creating one only touches the heap when a whole chunk has been used up.
+// Slots released by removed entities go on a free list and are handed out again before a new slot is used.
+class EntityPool
+{
+	static constexpr size_t ChunkSize = 1024;
+
+	std::vector<std::vector<Entity>> m_chunks;     // each chunk is reserved to ChunkSize up front so it never reallocates
+	std::vector<size_t>              m_freeSlots;
+	size_t                           m_size = 0;   // number of slots ever created, live or free
+	size_t                           m_reuses = 0; // how many times a released slot has been handed out again
+
+public:
+
+	EntityPool();
+
+	// Places the entity in a free slot if there is one, otherwise in a new slot at the end.
+	// The entity's id must already be the index returned by nextIndex().
+	Entity& acquire(Entity&& entity);
+	void release(size_t index);
+
+	// The index the next acquire() will use.
+	size_t nextIndex() const;
+
+	Entity& operator [] (size_t index);
+	const Entity& operator [] (size_t index) const;
+
+	size_t size() const;
+	size_t freeCount() const;
+	size_t reuseCount() const;
+	size_t memoryUsage() const;
+};
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "FlowField.h"
+
+#include <algorithm>
+
+namespace
+{
+	const int      StepX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	const int      StepY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	const uint8_t  Opposite[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+	const uint32_t StepCost[8] = { 10, 10, 10, 10, 14, 14, 14, 14 };
+}
+
+FlowField::FlowField(const TileGrid& grid)
+	: m_grid(&grid)
+{
+
+}
+
+FlowField::~FlowField()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_one();
+	if (m_worker.joinable()) { m_worker.join(); }
+}
+
+bool FlowField::queueNodeLess(const QueueNode& a, const QueueNode& b)
+{
+	// the std heap functions keep the largest on top, so this puts the lowest cost there
+	return a.cost > b.cost;
+}
+
+void FlowField::post(Request&& request)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (request.rebuild || !m_hasPending)
+		{
+			// a rebuild starts from a fresh copy of the grid, so anything queued before it is already included
+			m_pending = std::move(request);
+		}
+		else
+		{
+			m_pending.changes.insert(m_pending.changes.end(), request.changes.begin(), request.changes.end());
+		}
+		m_hasPending = true;
+	}
+	m_wake.notify_one();
+
+	if (!m_worker.joinable()) { m_worker = std::thread(&FlowField::workerLoop, this); }
+}
+
+void FlowField::setGoals(const std::vector<GridCell>& goals)
+{
+	m_goals = goals;
+
+	Request request;
+	request.rebuild = true;
+	request.width = m_grid->width();
+	request.height = m_grid->height();
+	request.blockMove = m_grid->blockMoveBits();
+	request.goals = m_goals;
+	m_gridVersion = m_grid->moveVersion();
+	post(std::move(request));
+}
+
+void FlowField::update()
+{
+	// nothing to keep up to date until there are goals
+	const TileGrid& grid = *m_grid;
+	if (m_goals.empty()) { m_gridVersion = grid.moveVersion(); }
+
+	if (grid.moveVersion() != m_gridVersion)
+	{
+		m_gridChanges.clear();
+		if (grid.width() != m_width || grid.height() != m_height || !grid.moveChangesSince(m_gridVersion, m_gridChanges))
+		{
+			setGoals(m_goals);
+		}
+		else
+		{
+			Request request;
+			for (const GridCell& cell : m_gridChanges)
+			{
+				request.changes.push_back({ cell, grid.blocksMove(cell.x, cell.y) });
+			}
+			m_gridVersion = grid.moveVersion();
+			post(std::move(request));
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_hasResult)
+	{
+		m_directions.swap(m_result);
+		m_width = m_resultWidth;
+		m_height = m_resultHeight;
+		m_hasResult = false;
+		++m_fieldVersion;
+	}
+}
+
+bool FlowField::hasGoals() const
+{
+	return !m_goals.empty();
+}
+
+bool FlowField::ready() const
+{
+	return m_fieldVersion > 0;
+}
+
+size_t FlowField::version() const
+{
+	return m_fieldVersion;
+}
+
+uint8_t FlowField::direction(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= m_width || y >= m_height) { return NoDirection; }
+	return m_directions[(size_t)y * m_width + x];
+}
+
+Vec2 FlowField::direction(const Vec2& worldPos) const
+{
+	static const float diagonal = 0.70710678f;
+	static const Vec2 unit[9] = { Vec2(1, 0), Vec2(-1, 0), Vec2(0, 1), Vec2(0, -1),
+		Vec2(diagonal, diagonal), Vec2(diagonal, -diagonal), Vec2(-diagonal, diagonal), Vec2(-diagonal, -diagonal), Vec2(0, 0) };
+
+	int x, y;
+	m_grid->worldToCell(worldPos, x, y);
+	return unit[direction(x, y)];
+}
+
+void FlowField::workerLoop()
+{
+	while (true)
+	{
+		Request request;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wake.wait(lock, [this] { return m_stop || m_hasPending; });
+			if (m_stop) { return; }
+
+			request = std::move(m_pending);
+			m_pending = Request();
+			m_hasPending = false;
+		}
+
+		if (request.rebuild) { rebuild(request); }
+		if (m_stride == 0) { continue; }
+
+		for (const Change& change : request.changes)
+		{
+			if (change.cell.x < 0 || change.cell.y < 0 || change.cell.x >= m_workWidth || change.cell.y >= m_workHeight) { continue; }
+			applyChange(change);
+		}
+		publish();
+	}
+}
+
+bool FlowField::canStep(uint32_t cell, int direction) const
+{
+	if (m_blocked[cell + m_offsets[direction]]) { return false; }
+
+	// a diagonal step needs both cells beside it to be free so it never cuts the corner of a wall
+	if (direction >= 4)
+	{
+		return !m_blocked[cell + StepX[direction]] && !m_blocked[cell + StepY[direction] * m_stride];
+	}
+	return true;
+}
+
+void FlowField::push(uint32_t cell)
+{
+	m_queue.push_back({ m_cost[cell], cell });
+	std::push_heap(m_queue.begin(), m_queue.end(), queueNodeLess);
+}
+
+void FlowField::rebuild(const Request& request)
+{
+	m_workWidth = request.width;
+	m_workHeight = request.height;
+	m_stride = m_workWidth + 2;
+	for (int i = 0; i < 8; ++i) { m_offsets[i] = StepX[i] + StepY[i] * m_stride; }
+
+	size_t cells = (size_t)m_stride * (m_workHeight + 2);
+	m_blocked.assign(cells, 1);
+	m_goal.assign(cells, 0);
+	m_cost.assign(cells, Unreachable);
+	m_step.assign(cells, NoDirection);
+	m_inAffected.assign(cells, 0);
+
+	for (int y = 0; y < m_workHeight; ++y)
+	{
+		for (int x = 0; x < m_workWidth; ++x)
+		{
+			size_t bit = (size_t)y * m_workWidth + x;
+			m_blocked[(size_t)(y + 1) * m_stride + x + 1] = (request.blockMove[bit / 64] >> (bit % 64)) & 1;
+		}
+	}
+
+	m_queue.clear();
+	for (const GridCell& goal : request.goals)
+	{
+		if (goal.x < 0 || goal.y < 0 || goal.x >= m_workWidth || goal.y >= m_workHeight) { continue; }
+
+		uint32_t cell = (uint32_t)((goal.y + 1) * m_stride + goal.x + 1);
+		m_goal[cell] = 1;
+		if (m_blocked[cell]) { continue; }
+		m_cost[cell] = 0;
+		push(cell);
+	}
+	propagate();
+}
+
+void FlowField::propagate()
+{
+	while (!m_queue.empty())
+	{
+		std::pop_heap(m_queue.begin(), m_queue.end(), queueNodeLess);
+		QueueNode node = m_queue.back();
+		m_queue.pop_back();
+
+		// a cell is queued again each time its cost drops, only the copy with its current cost is used
+		if (node.cost != m_cost[node.cell]) { continue; }
+
+		for (int i = 0; i < 8; ++i)
+		{
+			if (!canStep(node.cell, i)) { continue; }
+
+			uint32_t next = node.cell + m_offsets[i];
+			uint32_t cost = node.cost + StepCost[i];
+			if (m_goal[next] || cost >= m_cost[next]) { continue; }
+
+			m_cost[next] = cost;
+			m_step[next] = Opposite[i];
+			push(next);
+		}
+	}
+}
+
+void FlowField::relaxFromNeighbours(uint32_t cell)
+{
+	if (m_blocked[cell] || m_goal[cell]) { return; }
+
+	bool improved = false;
+	for (int i = 0; i < 8; ++i)
+	{
+		uint32_t next = cell + m_offsets[i];
+		if (m_cost[next] == Unreachable || !canStep(cell, i)) { continue; }
+
+		uint32_t cost = m_cost[next] + StepCost[i];
+		if (cost < m_cost[cell])
+		{
+			m_cost[cell] = cost;
+			m_step[cell] = (uint8_t)i;
+			improved = true;
+		}
+	}
+	if (improved) { push(cell); }
+}
+
+void FlowField::applyChange(const Change& change)
+{
+	uint32_t cell = (uint32_t)((change.cell.y + 1) * m_stride + change.cell.x + 1);
+	if ((m_blocked[cell] != 0) == change.blocked) { return; }
+
+	if (!change.blocked)
+	{
+		// Costs can only drop. Freeing the cell can also open diagonal steps between the cells around it,
+		// so those are looked at again as well, then the lower costs spread out from there.
+		m_blocked[cell] = 0;
+		if (m_goal[cell])
+		{
+			m_cost[cell] = 0;
+			push(cell);
+		}
+		relaxFromNeighbours(cell);
+		for (int i = 0; i < 8; ++i) { relaxFromNeighbours(cell + m_offsets[i]); }
+		propagate();
+		return;
+	}
+
+	// The new wall invalidates every cell whose step went into it or cut its corner, and every cell whose
+	// chain of steps led through one of those. Only these cells are reset and filled in again from the
+	// cells around them that still have a valid route.
+	m_blocked[cell] = 1;
+	m_affected.clear();
+	m_affected.push_back(cell);
+	m_inAffected[cell] = 1;
+	for (int i = 0; i < 8; ++i)
+	{
+		uint32_t next = cell + m_offsets[i];
+		if (m_step[next] != NoDirection && !m_inAffected[next] && !canStep(next, m_step[next]))
+		{
+			m_affected.push_back(next);
+			m_inAffected[next] = 1;
+		}
+	}
+
+	for (size_t a = 0; a < m_affected.size(); ++a)
+	{
+		uint32_t current = m_affected[a];
+		for (int i = 0; i < 8; ++i)
+		{
+			uint32_t next = current + m_offsets[i];
+			if (!m_inAffected[next] && m_step[next] == Opposite[i])
+			{
+				m_affected.push_back(next);
+				m_inAffected[next] = 1;
+			}
+		}
+	}
+
+	for (uint32_t affected : m_affected)
+	{
+		m_cost[affected] = Unreachable;
+		m_step[affected] = NoDirection;
+	}
+	for (uint32_t affected : m_affected)
+	{
+		relaxFromNeighbours(affected);
+		m_inAffected[affected] = 0;
+	}
+	propagate();
+}
+
+void FlowField::publish()
+{
+	std::vector<uint8_t> directions((size_t)m_workWidth * m_workHeight);
+	for (int y = 0; y < m_workHeight; ++y)
+	{
+		const uint8_t* row = &m_step[(size_t)(y + 1) * m_stride + 1];
+		std::copy(row, row + m_workWidth, directions.begin() + (size_t)y * m_workWidth);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_result.swap(directions);
+	m_resultWidth = m_workWidth;
+	m_resultHeight = m_workHeight;
+	m_hasResult = true;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "TileGrid.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// A flow field leading every cell of a TileGrid to the nearest of a set of goal cells. Any number of
+// entities heading for the same goals can read their next step from it in O(1) instead of each running
+// its own path search.
+//
+// The field is built on a worker thread, started the first time goals are set so a scene with nothing
+// heading anywhere doesn't keep an idle thread around. The main thread only copies the grid's blockMove bits when the
+// goals change and otherwise posts the cells whose blocking changed, and update() swaps in the newest
+// finished field. Entities keep following the previous field until the new one is done.
+//
+// The worker keeps the cost to reach the goal from every cell and the step each cell takes, which form
+// a tree rooted at the goals. A wall being built only resets the cells whose step led through it, and a
+// wall being removed only spreads the cheaper costs outward from the freed cell.
+class FlowField
+{
+public:
+
+	static constexpr uint8_t NoDirection = 8;
+
+private:
+
+	static constexpr uint32_t Unreachable = UINT32_MAX;
+
+	struct Change
+	{
+		GridCell cell;
+		bool     blocked = false;
+	};
+
+	struct QueueNode
+	{
+		uint32_t cost = 0;
+		uint32_t cell = 0;
+	};
+
+	// What the main thread hands to the worker. A new goal set replaces everything queued before it.
+	struct Request
+	{
+		bool                  rebuild = false;
+		int                   width = 0;
+		int                   height = 0;
+		std::vector<uint64_t> blockMove;
+		std::vector<GridCell> goals;
+		std::vector<Change>   changes;
+	};
+
+	const TileGrid*         m_grid = nullptr;
+	size_t                  m_gridVersion = 0;
+	std::vector<GridCell>   m_goals;
+	std::vector<GridCell>   m_gridChanges;
+
+	// the field entities read, only touched by the main thread
+	int                     m_width = 0;
+	int                     m_height = 0;
+	std::vector<uint8_t>    m_directions;
+	size_t                  m_fieldVersion = 0;
+
+	// shared between the threads, guarded by m_mutex
+	std::mutex              m_mutex;
+	std::condition_variable m_wake;
+	Request                 m_pending;
+	bool                    m_hasPending = false;
+	bool                    m_stop = false;
+	bool                    m_hasResult = false;
+	int                     m_resultWidth = 0;
+	int                     m_resultHeight = 0;
+	std::vector<uint8_t>    m_result;
+
+	// the worker's state, padded with a blocked border like the pathfinders
+	int                     m_stride = 0;
+	int                     m_workWidth = 0;
+	int                     m_workHeight = 0;
+	std::vector<uint8_t>    m_blocked;
+	std::vector<uint8_t>    m_goal;
+	std::vector<uint32_t>   m_cost;
+	std::vector<uint8_t>    m_step;      // the direction each cell moves in, NoDirection at goals and unreachable cells
+	std::vector<QueueNode>  m_queue;     // binary heap ordered by cost
+	std::vector<uint32_t>   m_affected;
+	std::vector<uint8_t>    m_inAffected;
+	int                     m_offsets[8] = {};
+
+	std::thread             m_worker;
+
+	static bool queueNodeLess(const QueueNode& a, const QueueNode& b);
+
+	void post(Request&& request);
+	void workerLoop();
+	void rebuild(const Request& request);
+	void applyChange(const Change& change);
+	bool canStep(uint32_t cell, int direction) const;
+	void relaxFromNeighbours(uint32_t cell);
+	void push(uint32_t cell);
+	void propagate();
+	void publish();
+
+public:
+
+	FlowField(const TileGrid& grid);
+	~FlowField();
+
+	FlowField(const FlowField&) = delete;
+	FlowField& operator = (const FlowField&) = delete;
+
+	// Starts building a field toward the given cells. Goals that block movement are skipped.
+	void setGoals(const std::vector<GridCell>& goals);
+
+	// Call once per frame. Sends any blocking changes to the worker and swaps in the newest finished field.
+	void update();
+
+	bool hasGoals() const;
+	bool ready() const;
+	size_t version() const;
+
+	// The direction to move from a cell, NoDirection at a goal, an unreachable cell or before the first field is ready.
+	uint8_t direction(int x, int y) const;
+
+	// Unit vector to move along from a world position, zero when there is nowhere to go.
+	Vec2 direction(const Vec2& worldPos) const;
+};
\ No newline at end of file
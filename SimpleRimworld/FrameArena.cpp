@@ -0,0 +1,68 @@
+#include "FrameArena.h"
+
+#include <cstdint>
+
+FrameArena::FrameArena(size_t capacity)
+	: m_buffer(capacity)
+{
+
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+	m_bytesUsed += bytes;
+	++m_allocations;
+
+	// round the next free address up to the requested alignment
+	uintptr_t base = reinterpret_cast<uintptr_t>(m_buffer.data());
+	uintptr_t aligned = (base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	size_t start = (size_t)(aligned - base);
+
+	if (start + bytes <= m_buffer.size())
+	{
+		m_offset = start + bytes;
+		return m_buffer.data() + start;
+	}
+
+	// The buffer is full for this frame, so give the allocation its own block. The vector's storage is
+	// allocated by operator new which is aligned for any fundamental type.
+	m_overflow.emplace_back(bytes + alignment);
+	uintptr_t overflowBase = reinterpret_cast<uintptr_t>(m_overflow.back().data());
+	return reinterpret_cast<void*>((overflowBase + alignment - 1) & ~(uintptr_t)(alignment - 1));
+}
+
+void FrameArena::reset()
+{
+	if (m_bytesUsed > m_peakBytes) { m_peakBytes = m_bytesUsed; }
+
+	// grow to the busiest frame seen, with room for alignment padding, so it fits in one buffer next time
+	if (!m_overflow.empty())
+	{
+		m_buffer.assign(m_peakBytes + m_peakBytes / 4, 0);
+		m_overflow.clear();
+	}
+
+	m_offset = 0;
+	m_bytesUsed = 0;
+	m_allocations = 0;
+}
+
+size_t FrameArena::bytesUsed() const
+{
+	return m_bytesUsed;
+}
+
+size_t FrameArena::peakBytes() const
+{
+	return m_bytesUsed > m_peakBytes ? m_bytesUsed : m_peakBytes;
+}
+
+size_t FrameArena::capacity() const
+{
+	return m_buffer.size();
+}
+
+size_t FrameArena::allocationCount() const
+{
+	return m_allocations;
+}
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// Scratch memory for allocations that only need to live until the end of the frame. Allocating is a
+// pointer bump and reset() releases everything at once. If a frame needs more than the buffer holds the
+// extra comes from overflow blocks, and the next reset() grows the buffer to fit so the steady state
+// never touches the heap. Nothing is reserved until a frame first uses it, so scenes that never allocate
+// here cost nothing. Nothing allocated here has its destructor run, so only use it for trivial types.
+class FrameArena
+{
+	std::vector<char>              m_buffer;
+	std::vector<std::vector<char>> m_overflow;
+	size_t                         m_offset = 0;      // next free byte in m_buffer
+	size_t                         m_bytesUsed = 0;   // bytes handed out this frame including overflow
+	size_t                         m_peakBytes = 0;   // the most bytes any frame has used
+	size_t                         m_allocations = 0; // allocations made this frame
+
+public:
+
+	FrameArena(size_t capacity = 0);
+
+	void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+	template <typename T>
+	T* allocateArray(size_t count)
+	{
+		return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	void reset();
+
+	size_t bytesUsed() const;
+	size_t peakBytes() const;
+	size_t capacity() const;
+	size_t allocationCount() const;
+};
+
+// Lets standard containers use the FrameArena for temporary storage, e.g.
+// ArenaVector<Entity*> scratch(arena);
+// Deallocation is a no-op, so reserve up front where possible to avoid wasting arena space on growth.
+template <typename T>
+class ArenaAllocator
+{
+	template <typename U> friend class ArenaAllocator;
+
+	FrameArena* m_arena = nullptr;
+
+public:
+
+	typedef T value_type;
+
+	ArenaAllocator(FrameArena& arena) : m_arena(&arena) {}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+	T* allocate(size_t count) { return m_arena->allocateArray<T>(count); }
+	void deallocate(T*, size_t) {}
+
+	template <typename U>
+	bool operator == (const ArenaAllocator<U>& rhs) const { return m_arena == rhs.m_arena; }
+
+	template <typename U>
+	bool operator != (const ArenaAllocator<U>& rhs) const { return m_arena != rhs.m_arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
\ No newline at end of file
@@ -1,19 +1,22 @@
 #include "GameEngine.h"
 #include "Scene_Home_Map.h"
-#include "Scene_Menu.h"
+#include "Scene_Loading.h"
 
 #include <fstream>
 #include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <chrono>
+#include <thread>
 
-GameEngine::GameEngine(const std::string& path)
+GameEngine::GameEngine(const std::string& path, bool headless)
+	: m_headless(headless)
 {
 	init(path);
 }
 
 void GameEngine::init(const std::string& path)
 {
-	m_assets.loadFromFile(path);
-
 	std::ifstream file("config.txt");
 	std::string str;
 	int wWidth = 0, wHeight = 0;
@@ -25,6 +28,18 @@ void GameEngine::init(const std::string& path)
 		{
 			file >> wWidth >> wHeight >> m_fps;
 		}
+		else if (str == "Simulation")
+		{
+			file >> m_tickRate >> m_maxTicksPerFrame;
+		}
+	}
+
+	if (m_tickRate <= 0) { m_tickRate = 60; }
+	if (m_maxTicksPerFrame == 0) { m_maxTicksPerFrame = 1; }
+	if (m_headless)
+	{
+		m_assets.loadFromFile(path, false);
+		return;
 	}
 
 	m_window.create(sf::VideoMode(wWidth, wHeight), "Game Dev Practice: Rimworld", sf::Style::Titlebar | sf::Style::Close);
@@ -32,12 +47,14 @@ void GameEngine::init(const std::string& path)
 
 	ImGui::SFML::Init(m_window);
 
-	changeScene("MENU", std::make_shared<Scene_Menu>(this));
+	// the window opens straight away and the loading scene finishes the assets as they are decoded
+	m_assets.beginLoading(path);
+	changeScene("LOADING", std::make_shared<Scene_Loading>(this));
 }
 
 std::shared_ptr<Scene> GameEngine::currentScene()
 {
-	return m_sceneMap[m_currentScene];
+	return m_scene;
 }
 
 bool GameEngine::isRunning()
@@ -54,15 +71,30 @@ void GameEngine::run()
 {
 	while (isRunning())
 	{
-		ImGui::SFML::Update(m_window, m_deltaClock.restart());
-		update();
+		PROFILE_BEGIN_FRAME();
+		sf::Time frameTime = m_deltaClock.restart();
+		ImGui::SFML::Update(m_window, frameTime);
+		update(frameTime);
 		ImGui::EndFrame();
+		PROFILE_END_FRAME();
 	}
+	endRecording();
 	ImGui::SFML::Shutdown();
 }
 
 void GameEngine::sUserInput()
 {
+	// Mouse moves are coalesced, only where the mouse ended up is sent: once the events have been read, or
+	// before any other action so the scene still sees them in order. Nothing here allocates.
+	bool mouseMoved = false;
+	Vec2 mouseMovedTo;
+	auto sendMouseMove = [&]()
+	{
+		if (!mouseMoved) { return; }
+		mouseMoved = false;
+		doAction(Action(ActionId::MouseMove, mouseMovedTo));
+	};
+
 	sf::Event event;
 	while (m_window.pollEvent(event))
 	{
@@ -73,45 +105,59 @@ void GameEngine::sUserInput()
 			quit();
 		}
 
-		if (event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased)
+		// F3 toggles the profiler in every scene
+		if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F3)
 		{
-			if (currentScene()->getActionMap().find(event.key.code) == currentScene()->getActionMap().end())
-			{ continue; }
-
-			const std::string actionType = (event.type == sf::Event::KeyPressed) ? "START" : "END";
-
-			currentScene()->doAction(Action(currentScene()->getActionMap().at(event.key.code), actionType));
+			m_showProfiler = !m_showProfiler;
+			continue;
 		}
 
-		auto mousePos = sf::Mouse::getPosition(m_window);
-		Vec2 pos((float)mousePos.x, (float)mousePos.y);
-		if (event.type == sf::Event::MouseButtonPressed)
+		// the recording is the only input during a replay
+		if (m_replaying) { continue; }
+
+		if (event.type == sf::Event::KeyPressed || event.type == sf::Event::KeyReleased)
 		{
-			switch (event.mouseButton.button)
-			{
-			case sf::Mouse::Left: { currentScene()->doAction(Action("LEFT_CLICK", "START", pos)); break; }
-			case sf::Mouse::Middle: { currentScene()->doAction(Action("MIDDLE_CLICK", "START", pos)); break; }
-			case sf::Mouse::Right: { currentScene()->doAction(Action("RIGHT_CLICK", "START", pos)); break; }
-			default: break;
-			}
+			ActionId id = m_scene->keyAction(event.key.code);
+			if (id == ActionId::None) { continue; }
+
+			sendMouseMove();
+			doAction(Action(id, (event.type == sf::Event::KeyPressed) ? ActionType::Start : ActionType::End));
 		}
 
-		if (event.type == sf::Event::MouseButtonReleased)
+		if (event.type == sf::Event::MouseButtonPressed || event.type == sf::Event::MouseButtonReleased)
 		{
+			ActionId id = ActionId::None;
 			switch (event.mouseButton.button)
 			{
-			case sf::Mouse::Left: { currentScene()->doAction(Action("LEFT_CLICK", "END", pos)); break; }
-			case sf::Mouse::Middle: { currentScene()->doAction(Action("MIDDLE_CLICK", "END", pos)); break; }
-			case sf::Mouse::Right: { currentScene()->doAction(Action("RIGHT_CLICK", "END", pos)); break; }
+			case sf::Mouse::Left: { id = ActionId::LeftClick; break; }
+			case sf::Mouse::Middle: { id = ActionId::MiddleClick; break; }
+			case sf::Mouse::Right: { id = ActionId::RightClick; break; }
 			default: break;
 			}
+			if (id == ActionId::None) { continue; }
+
+			sendMouseMove();
+			ActionType type = (event.type == sf::Event::MouseButtonPressed) ? ActionType::Start : ActionType::End;
+			doAction(Action(id, type, Vec2((float)event.mouseButton.x, (float)event.mouseButton.y)));
 		}
 
 		if (event.type == sf::Event::MouseMoved)
 		{
-			currentScene()->doAction(Action("MOUSE_MOVE", Vec2((float)event.mouseMove.x, (float)event.mouseMove.y)));
+			mouseMoved = true;
+			mouseMovedTo = Vec2((float)event.mouseMove.x, (float)event.mouseMove.y);
 		}
 	}
+	sendMouseMove();
+}
+
+void GameEngine::doAction(const Action& action)
+{
+	// held for the call, the action may change scenes and end the one handling it
+	std::shared_ptr<Scene> scene = m_scene;
+	if (!scene) { return; }
+
+	if (scene.get() == m_recordedScene) { m_recording.record(scene->currentFrame(), action); }
+	scene->doAction(action);
 }
 
 void GameEngine::changeScene(const std::string& sceneName, std::shared_ptr<Scene> scene, bool endCurrentScene)
@@ -134,7 +180,123 @@ void GameEngine::changeScene(const std::string& sceneName, std::shared_ptr<Scene
 	{
 		m_sceneMap.erase(m_sceneMap.find(m_currentScene));
 	}
+	// a recording covers one game scene until something else is shown
+	std::shared_ptr<Scene> next = m_sceneMap[sceneName];
+	if (m_recordedScene && m_scene.get() == m_recordedScene && next != m_scene) { endRecording(); }
+
 	m_currentScene = sceneName;
+	m_scene = next;
+	m_tickAccumulator = 0;
+}
+
+void GameEngine::runHeadless(const std::string& levelPath, size_t ticks)
+{
+	if (!m_headless)
+	{
+		std::cerr << "runHeadless needs an engine created headless." << std::endl;
+		return;
+	}
+
+	auto loadStart = std::chrono::steady_clock::now();
+	changeScene("PLAY", std::make_shared<Scene_Home_Map>(this, levelPath));
+	auto scene = currentScene();
+	double loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+
+	auto start = std::chrono::steady_clock::now();
+	scene->simulate(ticks);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printTimings(*scene, levelPath, loadSeconds, ticks, seconds);
+}
+
+void GameEngine::recordInput(const std::string& path)
+{
+	m_recordPath = path;
+}
+
+void GameEngine::beginRecording(const Scene* scene, const std::string& levelPath)
+{
+	if (m_recordPath.empty()) { return; }
+
+	endRecording();
+	if (m_recording.beginRecording(m_recordPath, levelPath)) { m_recordedScene = scene; }
+}
+
+void GameEngine::endRecording()
+{
+	if (!m_recordedScene) { return; }
+
+	m_recording.endRecording(m_scene.get() == m_recordedScene ? m_scene->currentFrame() : 0);
+	m_recordedScene = nullptr;
+}
+
+void GameEngine::replay(const std::string& recordingPath)
+{
+	if (!m_replay.load(recordingPath))
+	{
+		quit();
+		return;
+	}
+
+	auto loadStart = std::chrono::steady_clock::now();
+	if (!m_headless)
+	{
+		// the window is already showing the loading scene, finish the assets here so the replay starts on the level
+		while (!m_assets.updateLoading(sf::seconds(1))) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+	}
+	changeScene("PLAY", std::make_shared<Scene_Home_Map>(this, m_replay.levelPath()), m_scene != nullptr);
+	m_replayLoadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+
+	std::shared_ptr<Scene> scene = m_scene;
+	scene->setInterpolation(1.0f);
+	m_replayTicks = 0;
+	m_replayStart = std::chrono::steady_clock::now();
+	if (!m_headless)
+	{
+		m_window.setFramerateLimit(0);
+		m_replaying = true;
+		return;
+	}
+
+	while (stepReplay(*scene)) { ++m_replayTicks; }
+	finishReplay();
+}
+
+bool GameEngine::stepReplay(Scene& scene)
+{
+	Action action;
+	while (m_replay.nextAction(scene.currentFrame(), action)) { scene.doAction(action); }
+	if (m_replay.finished()) { return false; }
+
+	scene.simulate(1);
+	return true;
+}
+
+void GameEngine::finishReplay()
+{
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_replayStart).count();
+	std::cout << "Replayed:         " << m_replay.actionCount() << " actions" << (m_headless ? "\n" : ", drawing every tick\n");
+	printTimings(*m_scene, m_replay.levelPath(), m_replayLoadSeconds, m_replayTicks, seconds);
+	m_replaying = false;
+	quit();
+}
+
+void GameEngine::printTimings(const Scene& scene, const std::string& levelPath, double loadSeconds, size_t ticks, double seconds)
+{
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "Level:            " << levelPath << " (loaded in " << loadSeconds * 1000 << " ms)\n";
+	std::cout << "Ticks:            " << ticks << " in " << seconds * 1000 << " ms\n";
+	std::cout << "Ticks per second: " << (seconds > 0 ? ticks / seconds : 0) << "\n";
+	std::cout << std::left << std::setw(20) << "System" << std::right << std::setw(14) << "total ms"
+		<< std::setw(14) << "us per tick" << std::setw(10) << "share" << "\n";
+	for (const SystemTiming& timing : scene.systemTimings())
+	{
+		std::cout << std::left << std::setw(20) << timing.name << std::right
+			<< std::setw(14) << timing.seconds * 1000
+			<< std::setw(14) << (timing.calls ? timing.seconds * 1000000 / timing.calls : 0)
+			<< std::setw(9) << (seconds > 0 ? timing.seconds / seconds * 100 : 0) << "%\n";
+	}
+	std::cout << std::flush;
 }
 
 void GameEngine::quit()
@@ -142,48 +304,156 @@ void GameEngine::quit()
 	m_running = false;
 }
 
+Assets& GameEngine::assets()
+{
+	return m_assets;
+}
+
 const Assets& GameEngine::assets() const
 {
 	return m_assets;
 }
 
-void GameEngine::update()
+void GameEngine::update(sf::Time frameTime)
 {
 	if (!isRunning()) { return; }
 	if (m_sceneMap.empty()) { return; }
 
-	sUserInput();
-	currentScene()->simulate(m_simulationSpeed);
+	currentScene()->beginFrame();
+	{
+		PROFILE_SCOPE("Input");
+		sUserInput();
+	}
+
+	// Menus and the editor update once per drawn frame, the game itself runs in fixed ticks
+	size_t ticks = 0;
+	{
+		PROFILE_SCOPE("Simulation");
+		if (m_replaying)
+		{
+			if (stepReplay(*m_scene)) { ticks = 1; ++m_replayTicks; }
+			else { finishReplay(); }
+		}
+		else if (currentScene()->fixedTimestep()) { ticks = stepSimulation(frameTime); }
+		else
+		{
+			currentScene()->simulate(1);
+			ticks = 1;
+		}
+	}
+
+	m_ticksCounted += ticks;
+	float elapsed = m_tickRateClock.getElapsedTime().asSeconds();
+	if (elapsed >= 1.0f)
+	{
+		m_ticksPerSecond = m_ticksCounted / elapsed;
+		m_ticksCounted = 0;
+		m_tickRateClock.restart();
+	}
+
+	if (m_showProfiler) { Profiler::drawPanel(&m_showProfiler); }
 
 	// Render system is seperated from the scene update so the game engine can
 	// simulate a specified number of frames without rendering each frame of simulation.
-	currentScene()->sRender();
-	m_window.display();
+	{
+		PROFILE_SCOPE("Render");
+		currentScene()->sRender();
+	}
+	{
+		PROFILE_SCOPE("Display");
+		m_window.display();
+	}
+}
+
+size_t GameEngine::stepSimulation(sf::Time frameTime)
+{
+	auto scene = currentScene();
+	if (scene->isPaused())
+	{
+		m_tickAccumulator = 0;
+		scene->setInterpolation(1.0f);
+		return 0;
+	}
+
+	// A long stall, like the window being dragged, would otherwise be paid back as seconds of catch-up
+	const double maxFrameTime = 0.25;
+	const double tickLength = 1.0 / m_tickRate;
+	m_tickAccumulator += std::min((double)frameTime.asSeconds(), maxFrameTime) * m_simulationSpeed;
+
+	size_t ticks = 0;
+	while (m_tickAccumulator >= tickLength && ticks < m_maxTicksPerFrame)
+	{
+		PROFILE_SCOPE("Tick");
+		scene->simulate(1);
+		m_tickAccumulator -= tickLength;
+		++ticks;
+	}
+
+	// Out of budget for this frame. Drop the whole ticks still owed so the game runs slower
+	// for a moment instead of falling further behind every frame.
+	if (m_tickAccumulator >= tickLength) { m_tickAccumulator = std::fmod(m_tickAccumulator, tickLength); }
+
+	// how far the scene is between its last two ticks, used to draw moving entities smoothly
+	scene->setInterpolation((float)(m_tickAccumulator / tickLength));
+	return ticks;
 }
 
 void GameEngine::playSound(const std::string& soundName)
 {
+	if (m_headless) { return; }
+
 	if (soundName.find("Music") != std::string::npos)
 	{
-		if (!m_music.openFromFile(this->assets().getMusic(soundName)))
+		if (!m_music) { m_music = std::make_unique<sf::Music>(); }
+		if (!m_music->openFromFile(this->assets().getMusic(soundName)))
 		{
 			std::cerr << "Music failed to open.";
 		}
-		m_music.play();
+		m_music->play();
+	}
+	else
+	{
+		SoundId sound = m_assets.soundId(soundName);
+		if (sound.isValid()) { m_assets.getSound(sound).play(); }
 	}
-	else { m_assets.getSound(soundName).play(); }
 }
 
 void GameEngine::stopSound(const std::string& soundName)
 {
+	if (m_headless) { return; }
+
 	if (soundName.find("Music") != std::string::npos)
 	{
-		m_music.stop();
+		if (m_music) { m_music->stop(); }
+	}
+	else
+	{
+		SoundId sound = m_assets.soundId(soundName);
+		if (sound.isValid()) { m_assets.getSound(sound).stop(); }
 	}
-	else { m_assets.getSound(soundName).stop(); }
 }
 
 const int GameEngine::getFps() const
 {
 	return m_fps;
+}
+
+void GameEngine::setSimulationSpeed(size_t speed)
+{
+	m_simulationSpeed = speed > 0 ? speed : NormalSpeed;
+}
+
+size_t GameEngine::getSimulationSpeed() const
+{
+	return m_simulationSpeed;
+}
+
+int GameEngine::getTickRate() const
+{
+	return m_tickRate;
+}
+
+float GameEngine::getTicksPerSecond() const
+{
+	return m_ticksPerSecond;
 }
\ No newline at end of file
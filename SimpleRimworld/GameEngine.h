@@ -2,16 +2,26 @@
 
 #include "Scene.h"
 #include "Assets.h"
+#include "InputRecording.h"
 
 #include "imgui.h"
 #include "imgui-SFML.h"
 
 #include <memory>
+#include <chrono>
 
 typedef std::map<std::string, std::shared_ptr<Scene>> SceneMap;
 
 class GameEngine
 {
+public:
+
+	// Speed settings for scenes with a fixed timestep. Each one multiplies the number of ticks run per
+	// second without changing how often the window is drawn.
+	static constexpr size_t NormalSpeed = 1;
+	static constexpr size_t FastSpeed = 2;
+	static constexpr size_t SuperfastSpeed = 3;
+	static constexpr size_t UltraSpeed = 6;
 
 protected:
 
@@ -19,32 +29,82 @@ protected:
 	Assets           m_assets;
 	std::string      m_currentScene;
 	SceneMap         m_sceneMap;
-	size_t           m_simulationSpeed = 1;
+	std::shared_ptr<Scene> m_scene;               // m_sceneMap[m_currentScene], so it isn't looked up by name
+	size_t           m_simulationSpeed = NormalSpeed;
 	sf::Clock        m_deltaClock;
 	bool             m_running = true;
 	int              m_fps = 0 ;
-	sf::Music		 m_music;
+	int              m_tickRate = 60;             // ticks per second at NormalSpeed
+	size_t           m_maxTicksPerFrame = 30;     // catch-up budget, past this the game slows down instead
+	double           m_tickAccumulator = 0;       // simulation time owed, in seconds
+	sf::Clock        m_tickRateClock;
+	size_t           m_ticksCounted = 0;
+	float            m_ticksPerSecond = 0;
+	bool             m_headless = false;          // no window, textures, audio or ImGui
+	bool             m_showProfiler = false;
+	std::unique_ptr<sf::Music> m_music;           // opened on first use so a headless run never touches the audio device
+	InputRecording   m_recording;                 // the input sent to the game scene, when asked to record it
+	std::string      m_recordPath;
+	const Scene*     m_recordedScene = nullptr;
+	InputRecording   m_replay;                    // played back instead of the window's input
+	bool             m_replaying = false;
+	size_t           m_replayTicks = 0;
+	double           m_replayLoadSeconds = 0;
+	std::chrono::steady_clock::time_point m_replayStart;
 
 	void init(const std::string& path);
-	void update();
+	void update(sf::Time frameTime);
+	size_t stepSimulation(sf::Time frameTime);
 
 	void sUserInput();
 
+	// Sends the recorded actions due at the scene's tick, then runs it. Returns false once the recording is done.
+	bool stepReplay(Scene& scene);
+	void finishReplay();
+	void endRecording();
+	void printTimings(const Scene& scene, const std::string& levelPath, double loadSeconds, size_t ticks, double seconds);
+
 	std::shared_ptr<Scene> currentScene();
 
 public:
-	GameEngine(const std::string& path);
+	GameEngine(const std::string& path, bool headless = false);
 
 	void changeScene(const std::string& sceneName, std::shared_ptr<Scene> scene, bool endCurrentScene = false);
 
+	// Sends an action to the current scene, as input does.
+	void doAction(const Action& action);
+
 	void quit();
 	void run();
 
+	// Loads a level into the game scene and runs it for the given number of ticks as fast as it can,
+	// then prints the tick rate and the time spent in each system. Needs a headless engine.
+	void runHeadless(const std::string& levelPath, size_t ticks);
+
+	// Every game scene started from now on records the input it is sent to path, replacing the last one.
+	void recordInput(const std::string& path);
+
+	// Called by the game scene once its level is loaded, starts recording if recordInput() was called.
+	void beginRecording(const Scene* scene, const std::string& levelPath);
+
+	// Loads the level a recording was made in and sends it the recorded actions at their ticks, running
+	// one tick after another as fast as it can, then prints the timings and quits. A headless engine does
+	// it all here, otherwise run() plays it back and draws every tick, ignoring input from the window.
+	void replay(const std::string& recordingPath);
+
 	void playSound(const std::string& soundName);
 	void stopSound(const std::string& soundName);
 
 	sf::RenderWindow& window();
+	Assets& assets();
 	const Assets& assets() const;
 	bool isRunning();
 	const int getFps() const;
+
+	void setSimulationSpeed(size_t speed);
+	size_t getSimulationSpeed() const;
+	int getTickRate() const;
+
+	// Ticks the current scene actually ran over the last second.
+	float getTicksPerSecond() const;
 };
\ No newline at end of file
@@ -0,0 +1,629 @@
+#include "HierarchicalPathfinder.h"
+
+#include <algorithm>
+
+HierarchicalPathfinder::HierarchicalPathfinder()
+{
+
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(const TileGrid& grid)
+	: m_grid(&grid)
+{
+
+}
+
+bool HierarchicalPathfinder::openNodeLess(const OpenNode& a, const OpenNode& b)
+{
+	// the lowest f goes on top of the std heap, ties go to the node furthest along
+	if (a.f != b.f) { return a.f > b.f; }
+	return a.g < b.g;
+}
+
+uint32_t HierarchicalPathfinder::clusterOf(int x, int y) const
+{
+	return (uint32_t)((y / ClusterSize) * m_clustersX + x / ClusterSize);
+}
+
+void HierarchicalPathfinder::clusterBounds(uint32_t cluster, int& x0, int& y0, int& x1, int& y1) const
+{
+	x0 = (int)(cluster % m_clustersX) * ClusterSize;
+	y0 = (int)(cluster / m_clustersX) * ClusterSize;
+	x1 = std::min(x0 + ClusterSize, m_width);
+	y1 = std::min(y0 + ClusterSize, m_height);
+}
+
+uint32_t HierarchicalPathfinder::verticalBorder(int cx, int cy) const
+{
+	// the border between cluster (cx, cy) and the one to its right
+	return (uint32_t)(cy * (m_clustersX - 1) + cx);
+}
+
+uint32_t HierarchicalPathfinder::horizontalBorder(int cx, int cy) const
+{
+	// the border between cluster (cx, cy) and the one below it, numbered after every vertical border
+	return (uint32_t)((m_clustersX - 1) * m_clustersY + cy * m_clustersX + cx);
+}
+
+void HierarchicalPathfinder::clusterNodes(uint32_t cluster, std::vector<uint32_t>& out) const
+{
+	out.clear();
+	int cx = (int)(cluster % m_clustersX);
+	int cy = (int)(cluster / m_clustersX);
+
+	// border node lists hold pairs with the left or top cluster's node first
+	auto add = [&](uint32_t border, size_t side)
+	{
+		const auto& nodes = m_borders[border];
+		for (size_t i = side; i < nodes.size(); i += 2) { out.push_back(nodes[i]); }
+	};
+
+	if (cx > 0)				   { add(verticalBorder(cx - 1, cy), 1); }
+	if (cx < m_clustersX - 1)  { add(verticalBorder(cx, cy), 0); }
+	if (cy > 0)				   { add(horizontalBorder(cx, cy - 1), 1); }
+	if (cy < m_clustersY - 1)  { add(horizontalBorder(cx, cy), 0); }
+}
+
+bool HierarchicalPathfinder::blocked(int x, int y) const
+{
+	return m_blocked[(size_t)(y + 1) * m_stride + x + 1] != 0;
+}
+
+void HierarchicalPathfinder::sync()
+{
+	const TileGrid& grid = *m_grid;
+	if (grid.moveVersion() == m_gridVersion && !m_blocked.empty()) { return; }
+
+	m_changes.clear();
+	if (m_blocked.empty() || grid.width() != m_width || grid.height() != m_height
+		|| !grid.moveChangesSince(m_gridVersion, m_changes))
+	{
+		rebuildAll();
+	}
+	else
+	{
+		applyChanges();
+	}
+	m_gridVersion = grid.moveVersion();
+}
+
+void HierarchicalPathfinder::rebuildAll()
+{
+	const TileGrid& grid = *m_grid;
+	m_width = grid.width();
+	m_height = grid.height();
+	m_clustersX = (m_width + ClusterSize - 1) / ClusterSize;
+	m_clustersY = (m_height + ClusterSize - 1) / ClusterSize;
+	m_stride = m_width + 2;
+
+	m_blocked.assign((size_t)m_stride * (m_height + 2), 1);
+	for (int y = 0; y < m_height; ++y)
+	{
+		for (int x = 0; x < m_width; ++x)
+		{
+			m_blocked[(size_t)(y + 1) * m_stride + x + 1] = grid.blocksMove(x, y) ? 1 : 0;
+		}
+	}
+
+	m_nodes.clear();
+	m_freeNodes.clear();
+	size_t borders = (size_t)std::max(m_clustersX - 1, 0) * m_clustersY + (size_t)m_clustersX * std::max(m_clustersY - 1, 0);
+	m_borders.assign(borders, std::vector<uint32_t>());
+	m_dirtyBorders.assign(borders, 0);
+	m_dirtyClusters.assign((size_t)m_clustersX * m_clustersY, 0);
+
+	size_t localCells = ClusterSize * ClusterSize;
+	m_localCost.assign(localCells, 0);
+	m_localParent.assign(localCells, 0);
+	m_localOpened.assign(localCells, 0);
+	m_localClosed.assign(localCells, 0);
+	m_localSearch = 0;
+
+	for (uint32_t border = 0; border < borders; ++border) { buildBorder(border); }
+	for (uint32_t cluster = 0; cluster < m_dirtyClusters.size(); ++cluster) { buildCluster(cluster); }
+	m_componentsDirty = true;
+}
+
+void HierarchicalPathfinder::applyChanges()
+{
+	std::vector<uint32_t> borders;
+	std::vector<uint32_t> clusters;
+	auto markBorder = [&](uint32_t border)
+	{
+		if (!m_dirtyBorders[border]) { m_dirtyBorders[border] = 1; borders.push_back(border); }
+	};
+	auto markCluster = [&](uint32_t cluster)
+	{
+		if (!m_dirtyClusters[cluster]) { m_dirtyClusters[cluster] = 1; clusters.push_back(cluster); }
+	};
+
+	for (const GridCell& cell : m_changes)
+	{
+		m_blocked[(size_t)(cell.y + 1) * m_stride + cell.x + 1] = m_grid->blocksMove(cell.x, cell.y) ? 1 : 0;
+
+		// A cell inside a cluster only changes the walking costs of that cluster. A cell on the edge of
+		// a cluster can also change the entrances on that border, which changes the cluster on the other side.
+		int cx = cell.x / ClusterSize;
+		int cy = cell.y / ClusterSize;
+		markCluster(clusterOf(cell.x, cell.y));
+		if (cell.x % ClusterSize == 0 && cx > 0)							 { markBorder(verticalBorder(cx - 1, cy)); markCluster(clusterOf(cell.x - 1, cell.y)); }
+		if (cell.x % ClusterSize == ClusterSize - 1 && cx < m_clustersX - 1) { markBorder(verticalBorder(cx, cy)); markCluster(clusterOf(cell.x + 1, cell.y)); }
+		if (cell.y % ClusterSize == 0 && cy > 0)							 { markBorder(horizontalBorder(cx, cy - 1)); markCluster(clusterOf(cell.x, cell.y - 1)); }
+		if (cell.y % ClusterSize == ClusterSize - 1 && cy < m_clustersY - 1) { markBorder(horizontalBorder(cx, cy)); markCluster(clusterOf(cell.x, cell.y + 1)); }
+	}
+
+	for (uint32_t border : borders) { buildBorder(border); m_dirtyBorders[border] = 0; }
+	for (uint32_t cluster : clusters) { buildCluster(cluster); m_dirtyClusters[cluster] = 0; }
+	m_componentsDirty = true;
+}
+
+uint32_t HierarchicalPathfinder::allocateNode(int x, int y)
+{
+	uint32_t id;
+	if (!m_freeNodes.empty())
+	{
+		id = m_freeNodes.back();
+		m_freeNodes.pop_back();
+	}
+	else
+	{
+		id = (uint32_t)m_nodes.size();
+		m_nodes.emplace_back();
+	}
+
+	Node& node = m_nodes[id];
+	node.cell = { x, y };
+	node.cluster = clusterOf(x, y);
+	node.edges.clear();
+	return id;
+}
+
+void HierarchicalPathfinder::buildBorder(uint32_t border)
+{
+	// the clusters on both sides rebuild their edges afterwards, so freeing the old nodes is enough here
+	auto& nodes = m_borders[border];
+	for (uint32_t id : nodes)
+	{
+		m_nodes[id].edges.clear();
+		m_freeNodes.push_back(id);
+	}
+	nodes.clear();
+
+	// Walk along the border. sideX/sideY step from a cell to the cell facing it in the next cluster.
+	int verticalBorders = (m_clustersX - 1) * m_clustersY;
+	int startX, startY, stepX, stepY, sideX, sideY, length;
+	if ((int)border < verticalBorders)
+	{
+		int cx = (int)border % (m_clustersX - 1);
+		int cy = (int)border / (m_clustersX - 1);
+		startX = (cx + 1) * ClusterSize - 1;
+		startY = cy * ClusterSize;
+		stepX = 0; stepY = 1; sideX = 1; sideY = 0;
+		length = std::min(ClusterSize, m_height - startY);
+	}
+	else
+	{
+		int index = (int)border - verticalBorders;
+		int cx = index % m_clustersX;
+		int cy = index / m_clustersX;
+		startX = cx * ClusterSize;
+		startY = (cy + 1) * ClusterSize - 1;
+		stepX = 1; stepY = 0; sideX = 0; sideY = 1;
+		length = std::min(ClusterSize, m_width - startX);
+	}
+
+	// Every run of cells that are free on both sides becomes an entrance. Short runs get one crossing in
+	// the middle, long runs get one at each end so routes along the border don't need a detour.
+	auto addCrossing = [&](int i)
+	{
+		int x = startX + stepX * i;
+		int y = startY + stepY * i;
+		uint32_t a = allocateNode(x, y);
+		uint32_t b = allocateNode(x + sideX, y + sideY);
+		m_nodes[a].partner = b;
+		m_nodes[b].partner = a;
+		nodes.push_back(a);
+		nodes.push_back(b);
+	};
+
+	int runStart = -1;
+	for (int i = 0; i <= length; ++i)
+	{
+		bool open = false;
+		if (i < length)
+		{
+			int x = startX + stepX * i;
+			int y = startY + stepY * i;
+			open = !blocked(x, y) && !blocked(x + sideX, y + sideY);
+		}
+
+		if (open && runStart < 0) { runStart = i; }
+		if (!open && runStart >= 0)
+		{
+			int runLength = i - runStart;
+			if (runLength < 6) { addCrossing(runStart + runLength / 2); }
+			else
+			{
+				addCrossing(runStart);
+				addCrossing(i - 1);
+			}
+			runStart = -1;
+		}
+	}
+}
+
+uint32_t HierarchicalPathfinder::localIndex(uint32_t cluster, GridCell cell) const
+{
+	int x0, y0, x1, y1;
+	clusterBounds(cluster, x0, y0, x1, y1);
+	return (uint32_t)((cell.y - y0) * ClusterSize + (cell.x - x0));
+}
+
+void HierarchicalPathfinder::beginLocalSearch(uint32_t cluster, GridCell from)
+{
+	if (++m_localSearch == 0)
+	{
+		std::fill(m_localOpened.begin(), m_localOpened.end(), 0);
+		std::fill(m_localClosed.begin(), m_localClosed.end(), 0);
+		m_localSearch = 1;
+	}
+
+	uint32_t start = localIndex(cluster, from);
+	m_localCost[start] = 0;
+	m_localParent[start] = start;
+	m_localOpened[start] = m_localSearch;
+}
+
+bool HierarchicalPathfinder::searchCluster(uint32_t cluster, GridCell from, GridCell to)
+{
+	int x0, y0, x1, y1;
+	clusterBounds(cluster, x0, y0, x1, y1);
+	beginLocalSearch(cluster, from);
+
+	uint32_t goal = localIndex(cluster, to);
+	m_localOpen.clear();
+	m_localOpen.push_back({ Pathfinder::distance(from.x, from.y, to.x, to.y), 0, localIndex(cluster, from) });
+
+	static const int dx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static const int dy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+	while (!m_localOpen.empty())
+	{
+		std::pop_heap(m_localOpen.begin(), m_localOpen.end(), openNodeLess);
+		OpenNode node = m_localOpen.back();
+		m_localOpen.pop_back();
+
+		if (m_localClosed[node.node] == m_localSearch) { continue; }
+		m_localClosed[node.node] = m_localSearch;
+		if (node.node == goal) { return true; }
+
+		int x = x0 + (int)(node.node % ClusterSize);
+		int y = y0 + (int)(node.node / ClusterSize);
+		for (int i = 0; i < 8; ++i)
+		{
+			int nx = x + dx[i];
+			int ny = y + dy[i];
+			if (nx < x0 || ny < y0 || nx >= x1 || ny >= y1 || blocked(nx, ny)) { continue; }
+
+			bool diagonal = i >= 4;
+			if (diagonal && (blocked(nx, y) || blocked(x, ny))) { continue; }
+
+			uint32_t next = (uint32_t)((ny - y0) * ClusterSize + (nx - x0));
+			if (m_localClosed[next] == m_localSearch) { continue; }
+
+			uint32_t g = node.g + (diagonal ? Pathfinder::DiagonalCost : Pathfinder::StraightCost);
+			if (m_localOpened[next] == m_localSearch && g >= m_localCost[next]) { continue; }
+
+			m_localOpened[next] = m_localSearch;
+			m_localCost[next] = g;
+			m_localParent[next] = node.node;
+			m_localOpen.push_back({ g + Pathfinder::distance(nx, ny, to.x, to.y), g, next });
+			std::push_heap(m_localOpen.begin(), m_localOpen.end(), openNodeLess);
+		}
+	}
+	return false;
+}
+
+void HierarchicalPathfinder::floodCluster(uint32_t cluster, GridCell from)
+{
+	int x0, y0, x1, y1;
+	clusterBounds(cluster, x0, y0, x1, y1);
+	beginLocalSearch(cluster, from);
+
+	// Step costs are small integers, so Dijkstra can keep its queue in buckets by cost instead of a heap.
+	// No step costs more than the number of buckets, so the buckets being filled never wrap onto the one being emptied.
+	const size_t bucketCount = Pathfinder::DiagonalCost + 2;
+	if (m_localBuckets.size() != bucketCount) { m_localBuckets.assign(bucketCount, std::vector<uint32_t>()); }
+
+	static const int dx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static const int dy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+	m_localBuckets[0].push_back(localIndex(cluster, from));
+	size_t queued = 1;
+	for (uint32_t cost = 0; queued > 0; ++cost)
+	{
+		auto& bucket = m_localBuckets[cost % bucketCount];
+		while (!bucket.empty())
+		{
+			uint32_t cell = bucket.back();
+			bucket.pop_back();
+			--queued;
+
+			// a cell can be queued again at a lower cost, only the copy matching its best cost is used
+			if (m_localClosed[cell] == m_localSearch || m_localCost[cell] != cost) { continue; }
+			m_localClosed[cell] = m_localSearch;
+
+			int x = x0 + (int)(cell % ClusterSize);
+			int y = y0 + (int)(cell / ClusterSize);
+			for (int i = 0; i < 8; ++i)
+			{
+				int nx = x + dx[i];
+				int ny = y + dy[i];
+				if (nx < x0 || ny < y0 || nx >= x1 || ny >= y1 || blocked(nx, ny)) { continue; }
+
+				bool diagonal = i >= 4;
+				if (diagonal && (blocked(nx, y) || blocked(x, ny))) { continue; }
+
+				uint32_t next = (uint32_t)((ny - y0) * ClusterSize + (nx - x0));
+				uint32_t g = cost + (diagonal ? Pathfinder::DiagonalCost : Pathfinder::StraightCost);
+				if (m_localOpened[next] == m_localSearch && g >= m_localCost[next]) { continue; }
+
+				m_localOpened[next] = m_localSearch;
+				m_localCost[next] = g;
+				m_localParent[next] = cell;
+				m_localBuckets[g % bucketCount].push_back(next);
+				++queued;
+			}
+		}
+	}
+}
+
+void HierarchicalPathfinder::buildCluster(uint32_t cluster)
+{
+	clusterNodes(cluster, m_scratchNodes);
+	for (uint32_t id : m_scratchNodes) { m_nodes[id].edges.clear(); }
+
+	// costs are the same both ways, so each search fills in the edges to the nodes after it in both directions
+	for (size_t i = 0; i < m_scratchNodes.size(); ++i)
+	{
+		uint32_t a = m_scratchNodes[i];
+		floodCluster(cluster, m_nodes[a].cell);
+		for (size_t j = i + 1; j < m_scratchNodes.size(); ++j)
+		{
+			uint32_t b = m_scratchNodes[j];
+			uint32_t local = localIndex(cluster, m_nodes[b].cell);
+			if (m_localClosed[local] != m_localSearch) { continue; }
+
+			m_nodes[a].edges.push_back({ b, m_localCost[local] });
+			m_nodes[b].edges.push_back({ a, m_localCost[local] });
+		}
+	}
+	++m_clustersRebuilt;
+}
+
+void HierarchicalPathfinder::buildComponents()
+{
+	// label the nodes that can reach each other so a request between two of them that can't fails at once
+	m_components.assign(m_nodes.size(), 0);
+	for (uint32_t id : m_freeNodes) { m_components[id] = UINT32_MAX; }
+
+	uint32_t component = 0;
+	std::vector<uint32_t>& stack = m_scratchNodes;
+	for (uint32_t id = 0; id < m_nodes.size(); ++id)
+	{
+		if (m_components[id] != 0) { continue; }
+
+		m_components[id] = ++component;
+		stack.clear();
+		stack.push_back(id);
+		while (!stack.empty())
+		{
+			const Node& node = m_nodes[stack.back()];
+			stack.pop_back();
+			if (m_components[node.partner] == 0) { m_components[node.partner] = component; stack.push_back(node.partner); }
+			for (const Edge& edge : node.edges)
+			{
+				if (m_components[edge.to] == 0) { m_components[edge.to] = component; stack.push_back(edge.to); }
+			}
+		}
+	}
+	m_componentsDirty = false;
+}
+
+void HierarchicalPathfinder::linkToCluster(GridCell cell, std::vector<Edge>& edges)
+{
+	edges.clear();
+	uint32_t cluster = clusterOf(cell.x, cell.y);
+	floodCluster(cluster, cell);
+
+	clusterNodes(cluster, m_scratchNodes);
+	for (uint32_t id : m_scratchNodes)
+	{
+		uint32_t local = localIndex(cluster, m_nodes[id].cell);
+		if (m_localClosed[local] == m_localSearch) { edges.push_back({ id, m_localCost[local] }); }
+	}
+}
+
+bool HierarchicalPathfinder::searchGraph(GridCell start, GridCell goal, std::vector<GridCell>& waypoints)
+{
+	linkToCluster(start, m_startEdges);
+	linkToCluster(goal, m_goalEdges);
+	if (m_startEdges.empty() || m_goalEdges.empty()) { return false; }
+
+	// Give up before searching when no entrance the start reaches is connected to one the goal reaches.
+	// Labelling the graph costs about as much as a search that fails, so after the graph changes it is
+	// only done once a search has actually failed.
+	if (!m_componentsDirty)
+	{
+		bool connected = false;
+		for (const Edge& s : m_startEdges)
+		{
+			for (const Edge& g : m_goalEdges)
+			{
+				if (m_components[s.to] == m_components[g.to]) { connected = true; }
+			}
+		}
+		if (!connected) { return false; }
+	}
+
+	uint32_t startId = (uint32_t)m_nodes.size();
+	uint32_t goalId = startId + 1;
+	if (m_cost.size() < m_nodes.size() + 2)
+	{
+		m_cost.resize(m_nodes.size() + 2, 0);
+		m_parent.resize(m_nodes.size() + 2, 0);
+		m_opened.resize(m_nodes.size() + 2, 0);
+		m_closed.resize(m_nodes.size() + 2, 0);
+	}
+	if (++m_search == 0)
+	{
+		std::fill(m_opened.begin(), m_opened.end(), 0);
+		std::fill(m_closed.begin(), m_closed.end(), 0);
+		m_search = 1;
+	}
+
+	// On a map with scattered obstacles the best route is only a few percent longer than the straight line,
+	// so a plain A* heuristic leaves a wide band of near ties that all get searched. Overestimating the rest
+	// of the route makes the search head for the goal instead, and the graph is already an approximation.
+	auto weighted = [](uint32_t h) { return h * HeuristicWeightNum / HeuristicWeightDen; };
+
+	uint32_t goalCluster = clusterOf(goal.x, goal.y);
+	auto cellOf = [&](uint32_t id) { return id == startId ? start : id == goalId ? goal : m_nodes[id].cell; };
+	auto relax = [&](uint32_t from, uint32_t g, uint32_t to, uint32_t cost)
+	{
+		if (m_closed[to] == m_search) { return; }
+		uint32_t next = g + cost;
+		if (m_opened[to] == m_search && next >= m_cost[to]) { return; }
+
+		m_opened[to] = m_search;
+		m_cost[to] = next;
+		m_parent[to] = from;
+		GridCell cell = cellOf(to);
+		m_open.push_back({ next + weighted(Pathfinder::distance(cell.x, cell.y, goal.x, goal.y)), next, to });
+		std::push_heap(m_open.begin(), m_open.end(), openNodeLess);
+	};
+
+	m_open.clear();
+	m_opened[startId] = m_search;
+	m_cost[startId] = 0;
+	m_parent[startId] = startId;
+	m_open.push_back({ weighted(Pathfinder::distance(start.x, start.y, goal.x, goal.y)), 0, startId });
+
+	while (!m_open.empty())
+	{
+		std::pop_heap(m_open.begin(), m_open.end(), openNodeLess);
+		OpenNode node = m_open.back();
+		m_open.pop_back();
+
+		if (m_closed[node.node] == m_search) { continue; }
+		m_closed[node.node] = m_search;
+		if (node.node == goalId) { break; }
+
+		if (node.node == startId)
+		{
+			for (const Edge& edge : m_startEdges) { relax(startId, node.g, edge.to, edge.cost); }
+			continue;
+		}
+
+		const Node& current = m_nodes[node.node];
+		relax(node.node, node.g, current.partner, Pathfinder::StraightCost);
+		for (const Edge& edge : current.edges) { relax(node.node, node.g, edge.to, edge.cost); }
+		if (current.cluster == goalCluster)
+		{
+			for (const Edge& edge : m_goalEdges)
+			{
+				if (edge.to == node.node) { relax(node.node, node.g, goalId, edge.cost); }
+			}
+		}
+	}
+
+	if (m_closed[goalId] != m_search)
+	{
+		if (m_componentsDirty) { buildComponents(); }
+		return false;
+	}
+
+	for (uint32_t id = goalId; ; id = m_parent[id])
+	{
+		// the start or goal can sit on an entrance, which would give the same cell twice in a row
+		GridCell cell = cellOf(id);
+		if (waypoints.empty() || waypoints.back() != cell) { waypoints.push_back(cell); }
+		if (id == startId) { break; }
+	}
+	std::reverse(waypoints.begin(), waypoints.end());
+	return true;
+}
+
+bool HierarchicalPathfinder::findPath(int startX, int startY, int goalX, int goalY, HierarchicalPath& out)
+{
+	out.waypoints.clear();
+	out.firstLeg.clear();
+	if (m_grid == nullptr) { return false; }
+
+	sync();
+	if (startX < 0 || startY < 0 || startX >= m_width || startY >= m_height) { return false; }
+	if (goalX < 0 || goalY < 0 || goalX >= m_width || goalY >= m_height || blocked(goalX, goalY)) { return false; }
+
+	GridCell start = { startX, startY };
+	GridCell goal = { goalX, goalY };
+
+	// When both ends are in the same cluster try a path that stays inside it first. It can still
+	// be found through the graph if the only way around leaves the cluster.
+	bool found = false;
+	if (clusterOf(startX, startY) == clusterOf(goalX, goalY) && searchCluster(clusterOf(startX, startY), start, goal))
+	{
+		out.waypoints.push_back(start);
+		if (goal != start) { out.waypoints.push_back(goal); }
+		found = true;
+	}
+	else
+	{
+		found = searchGraph(start, goal, out.waypoints);
+	}
+
+	if (!found) { return false; }
+	if (out.waypoints.size() == 1) { out.firstLeg.push_back(start); }
+	else { refineLeg(out, 0, out.firstLeg); }
+	return true;
+}
+
+bool HierarchicalPathfinder::refineLeg(const HierarchicalPath& path, size_t leg, Path& out)
+{
+	out.clear();
+	if (leg + 1 >= path.waypoints.size()) { return false; }
+
+	sync();
+	GridCell from = path.waypoints[leg];
+	GridCell to = path.waypoints[leg + 1];
+
+	// a leg either crosses a border in one step or stays inside one cluster
+	uint32_t cluster = clusterOf(from.x, from.y);
+	if (cluster != clusterOf(to.x, to.y))
+	{
+		out.push_back(from);
+		out.push_back(to);
+		return true;
+	}
+
+	if (!searchCluster(cluster, from, to)) { return false; }
+
+	int x0, y0, x1, y1;
+	clusterBounds(cluster, x0, y0, x1, y1);
+	for (uint32_t local = localIndex(cluster, to); ; local = m_localParent[local])
+	{
+		out.push_back({ x0 + (int)(local % ClusterSize), y0 + (int)(local / ClusterSize) });
+		if (m_localParent[local] == local) { break; }
+	}
+	std::reverse(out.begin(), out.end());
+	return true;
+}
+
+size_t HierarchicalPathfinder::nodeCount() const
+{
+	return m_nodes.size() - m_freeNodes.size();
+}
+
+size_t HierarchicalPathfinder::clustersRebuilt() const
+{
+	return m_clustersRebuilt;
+}
\ No newline at end of file
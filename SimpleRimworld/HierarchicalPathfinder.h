@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Pathfinder.h"
+
+// A route from the hierarchical pathfinder. The waypoints are the start, the cluster entrances the route
+// passes through and the goal. Only the first leg comes back as grid cells, the others are turned into
+// cells with refineLeg() when the walker gets to them.
+struct HierarchicalPath
+{
+	std::vector<GridCell> waypoints;
+	Path                  firstLeg;
+};
+
+// HPA* over a TileGrid. The grid is split into square clusters and wherever two neighbouring clusters
+// have free cells facing each other across their border an entrance is placed, a pair of nodes joined by
+// a single step. Inside each cluster the walking cost between every pair of its entrances is worked out
+// ahead of time, which gives a small graph that a long route can be found on without touching the cells
+// in between.
+//
+// A query links the start and goal into the graph with a search of their own cluster, searches the graph,
+// and refines the first leg at full resolution. Every leg stays inside one cluster, so refining one is a
+// search of at most ClusterSize x ClusterSize cells. Paths are close to the shortest but not guaranteed to be.
+//
+// When blocking cells change, only the borders and clusters those cells are in get rebuilt. The changes
+// are read from the grid's move log the next time a path is asked for.
+class HierarchicalPathfinder
+{
+public:
+
+	static constexpr int ClusterSize = 16;
+
+private:
+
+	static constexpr uint32_t HeuristicWeightNum = 3;  // the graph search uses 3/2 of the straight line distance
+	static constexpr uint32_t HeuristicWeightDen = 2;
+
+	struct Edge
+	{
+		uint32_t to = 0;
+		uint32_t cost = 0;
+	};
+
+	struct Node
+	{
+		GridCell          cell;
+		uint32_t          cluster = 0;
+		uint32_t          partner = 0;  // the node on the other side of the border this entrance crosses
+		std::vector<Edge> edges;        // the other entrances of the same cluster that can be walked to
+	};
+
+	struct OpenNode
+	{
+		uint32_t f = 0;
+		uint32_t g = 0;
+		uint32_t node = 0;
+	};
+
+	const TileGrid*                    m_grid = nullptr;
+	size_t                             m_gridVersion = 0;
+	int                                m_width = 0;
+	int                                m_height = 0;
+	int                                m_clustersX = 0;
+	int                                m_clustersY = 0;
+	int                                m_stride = 0;      // width of m_blocked, the grid width + 2
+	std::vector<uint8_t>               m_blocked;         // copy of the grid's blockMove bits with a blocking border
+
+	std::vector<Node>                  m_nodes;
+	std::vector<uint32_t>              m_freeNodes;
+	std::vector<std::vector<uint32_t>> m_borders;         // entrance node pairs on each border, left or top node first
+	std::vector<uint32_t>              m_components;      // connected component of each node
+	bool                               m_componentsDirty = true;
+
+	std::vector<uint8_t>               m_dirtyBorders;
+	std::vector<uint8_t>               m_dirtyClusters;
+	std::vector<GridCell>              m_changes;
+	std::vector<uint32_t>              m_scratchNodes;
+
+	// state for searches inside a single cluster, indexed by the cell's position in the cluster
+	std::vector<uint32_t>              m_localCost;
+	std::vector<uint32_t>              m_localParent;
+	std::vector<uint32_t>              m_localOpened;
+	std::vector<uint32_t>              m_localClosed;
+	std::vector<OpenNode>              m_localOpen;
+	std::vector<std::vector<uint32_t>> m_localBuckets;    // flood fill queue, bucket i holds the cells whose cost % size is i
+	uint32_t                           m_localSearch = 0;
+
+	// state for searches of the entrance graph, the start and goal use the two ids after the last node
+	std::vector<uint32_t>              m_cost;
+	std::vector<uint32_t>              m_parent;
+	std::vector<uint32_t>              m_opened;
+	std::vector<uint32_t>              m_closed;
+	std::vector<OpenNode>              m_open;
+	uint32_t                           m_search = 0;
+	std::vector<Edge>                  m_startEdges;
+	std::vector<Edge>                  m_goalEdges;
+
+	size_t                             m_clustersRebuilt = 0;
+
+	static bool openNodeLess(const OpenNode& a, const OpenNode& b);
+
+	uint32_t clusterOf(int x, int y) const;
+	void clusterBounds(uint32_t cluster, int& x0, int& y0, int& x1, int& y1) const;
+	void clusterNodes(uint32_t cluster, std::vector<uint32_t>& out) const;
+	uint32_t verticalBorder(int cx, int cy) const;
+	uint32_t horizontalBorder(int cx, int cy) const;
+	bool blocked(int x, int y) const;
+
+	void sync();
+	void rebuildAll();
+	void applyChanges();
+	uint32_t allocateNode(int x, int y);
+	void buildBorder(uint32_t border);
+	void buildCluster(uint32_t cluster);
+	void buildComponents();
+
+	// Both fill the local search state. searchCluster() is an A* search that stops at the goal,
+	// floodCluster() finds the cost from a cell to every cell of the cluster it can reach.
+	bool searchCluster(uint32_t cluster, GridCell from, GridCell to);
+	void floodCluster(uint32_t cluster, GridCell from);
+	void beginLocalSearch(uint32_t cluster, GridCell from);
+	uint32_t localIndex(uint32_t cluster, GridCell cell) const;
+	void linkToCluster(GridCell cell, std::vector<Edge>& edges);
+	bool searchGraph(GridCell start, GridCell goal, std::vector<GridCell>& waypoints);
+
+public:
+
+	HierarchicalPathfinder();
+	HierarchicalPathfinder(const TileGrid& grid);
+
+	// Finds a route from start to goal and refines its first leg. Returns false and leaves out empty
+	// when the goal is blocked or can't be reached.
+	bool findPath(int startX, int startY, int goalX, int goalY, HierarchicalPath& out);
+
+	// Writes the cells from waypoints[leg] to waypoints[leg + 1] into out, both included.
+	bool refineLeg(const HierarchicalPath& path, size_t leg, Path& out);
+
+	size_t nodeCount() const;
+	size_t clustersRebuilt() const;
+};
\ No newline at end of file
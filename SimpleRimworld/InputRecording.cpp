@@ -0,0 +1,135 @@
+#include "InputRecording.h"
+
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+	const char Magic[4] = { 'S', 'R', 'I', 'R' };
+
+	struct Header
+	{
+		char     magic[4];
+		uint32_t version;
+		uint32_t levelPathBytes;  // the level path follows the header, without a terminator
+		uint32_t padding;
+	};
+
+	static_assert(sizeof(InputRecording::Record) == 16, "records are written to the file as they are");
+}
+
+bool InputRecording::beginRecording(const std::string& path, const std::string& levelPath)
+{
+	if (m_file.is_open()) { endRecording(m_lastTick); }
+
+	m_file.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_file)
+	{
+		std::cerr << "Could not open " << path << " to record input" << std::endl;
+		return false;
+	}
+
+	Header header = {};
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.levelPathBytes = (uint32_t)levelPath.size();
+	m_file.write((const char*)&header, sizeof(header));
+	m_file.write(levelPath.data(), levelPath.size());
+	m_levelPath = levelPath;
+	m_lastTick = 0;
+	return true;
+}
+
+void InputRecording::record(size_t tick, const Action& action)
+{
+	if (!m_file.is_open()) { return; }
+
+	Record record;
+	record.tick = (uint32_t)tick;
+	record.action = action.id();
+	record.type = action.type();
+	record.x = action.pos().x;
+	record.y = action.pos().y;
+	m_file.write((const char*)&record, sizeof(record));
+	m_lastTick = record.tick;
+}
+
+void InputRecording::endRecording(size_t tick)
+{
+	if (!m_file.is_open()) { return; }
+
+	Record end;
+	end.tick = std::max(m_lastTick, (uint32_t)tick);
+	m_file.write((const char*)&end, sizeof(end));
+	m_file.close();
+}
+
+bool InputRecording::isRecording() const
+{
+	return m_file.is_open();
+}
+
+bool InputRecording::load(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	Header header = {};
+	if (!file.read((char*)&header, sizeof(header)) || std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version)
+	{
+		std::cerr << "Not an input recording: " << path << std::endl;
+		return false;
+	}
+
+	std::string levelPath(header.levelPathBytes, '\0');
+	if (!file.read(&levelPath[0], levelPath.size()))
+	{
+		std::cerr << "Input recording is cut short: " << path << std::endl;
+		return false;
+	}
+
+	// a recording that was never ended stops after its last whole record
+	std::vector<Record> records;
+	Record record;
+	while (file.read((char*)&record, sizeof(record)))
+	{
+		if (record.action >= ActionId::Count || record.type >= ActionType::Count)
+		{
+			std::cerr << "Input recording has an unknown action: " << path << std::endl;
+			return false;
+		}
+		records.push_back(record);
+	}
+
+	m_records = std::move(records);
+	m_next = 0;
+	m_levelPath = levelPath;
+	return true;
+}
+
+bool InputRecording::nextAction(size_t tick, Action& action)
+{
+	while (m_next < m_records.size() && m_records[m_next].tick <= tick)
+	{
+		const Record& record = m_records[m_next++];
+		if (record.action == ActionId::None) { continue; }
+
+		action = Action(record.action, record.type, Vec2(record.x, record.y));
+		return true;
+	}
+	return false;
+}
+
+bool InputRecording::finished() const
+{
+	return m_next >= m_records.size();
+}
+
+size_t InputRecording::actionCount() const
+{
+	return std::count_if(m_records.begin(), m_records.end(), [](const Record& record) { return record.action != ActionId::None; });
+}
+
+const std::string& InputRecording::levelPath() const
+{
+	return m_levelPath;
+}
\ No newline at end of file
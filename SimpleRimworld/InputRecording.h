@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Action.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+// The actions sent to a game scene and the tick each one arrived on, so a session can be played back.
+// Ticks are the scene's currentFrame(): an action recorded on tick N was handled before tick N ran, and
+// replaying the level sends it at the same point. The simulation only depends on its ticks and input,
+// so a replay runs the same ticks as the session it was recorded from however fast it goes.
+//
+// The file is a header with the level path, then one fixed size record per action, appended as they
+// happen. When recording stops a record with no action marks the tick it stopped on.
+class InputRecording
+{
+public:
+
+	static constexpr uint32_t Version = 1;
+
+	struct Record
+	{
+		uint32_t   tick = 0;
+		ActionId   action = ActionId::None;  // None marks the end of the recording
+		ActionType type = ActionType::None;
+		uint16_t   padding = 0;
+		float      x = 0;
+		float      y = 0;
+	};
+
+private:
+
+	std::ofstream       m_file;
+	uint32_t            m_lastTick = 0;
+	std::vector<Record> m_records;          // a recording read back to replay
+	size_t              m_next = 0;         // the next record to replay
+	std::string         m_levelPath;
+
+public:
+
+	// Starts a new recording at path, replacing the file.
+	bool beginRecording(const std::string& path, const std::string& levelPath);
+	void record(size_t tick, const Action& action);
+	void endRecording(size_t tick);
+	bool isRecording() const;
+
+	// Reads a recording to replay. Returns false if it can't be read or was written by another version.
+	bool load(const std::string& path);
+
+	// The next recorded action due by the given tick, in the order they were recorded. Returns false once
+	// there are none until a later tick.
+	bool nextAction(size_t tick, Action& action);
+
+	// true once every record has been replayed
+	bool finished() const;
+	size_t actionCount() const;
+
+	const std::string& levelPath() const;
+};
\ No newline at end of file
@@ -87,6 +87,8 @@ bool MemoryMapping::open(const std::string& filename)
 		return false;
 	}
 
+	// zero bytes maps the whole file
+	m_size = mappedBytes != 0 ? mappedBytes : size_t(filesize - offset);
 	return true;
 }
 
@@ -100,9 +102,15 @@ void MemoryMapping::close()
 	m_hFileMapping = NULL;
 	::CloseHandle(m_hFile);
 	m_hFile = NULL;
+	m_size = 0;
 }
 
 char* MemoryMapping::getData()
 {
 	return static_cast<char*>(m_mapViewOfFile);
+}
+
+size_t MemoryMapping::getSize() const
+{
+	return m_size;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ class MemoryMapping
 	HANDLE		m_hFile				= NULL;
 	HANDLE		m_hFileMapping		= NULL;
 	void*		m_mapViewOfFile		= nullptr;
+	size_t		m_size				= 0;
 
 	MemoryMapping();
 
@@ -18,5 +19,6 @@ public:
 	MemoryMapping(const std::string& filename);
 
 	char* getData();
+	size_t getSize() const;
 	void close();
 };
\ No newline at end of file
@@ -0,0 +1,307 @@
+#include "Pathfinder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+Pathfinder::Pathfinder()
+{
+
+}
+
+Pathfinder::Pathfinder(const TileGrid& grid, size_t cacheCapacity)
+	: m_grid(&grid)
+	, m_cacheCapacity(cacheCapacity)
+{
+	if (cacheCapacity == 0) { return; }
+
+	size_t slots = 1;
+	while (slots < cacheCapacity * 2) { slots *= 2; }
+	m_cache.resize(cacheCapacity);
+	m_cacheKeys.assign(slots, 0);
+	m_cacheSlots.assign(slots, NoEntry);
+}
+
+bool Pathfinder::openNodeLess(const OpenNode& a, const OpenNode& b)
+{
+	// std heap functions keep the largest element on top, so "less" puts the lowest f on top.
+	// Ties go to the node furthest along so the search runs straight at the goal across open ground.
+	if (a.f != b.f) { return a.f > b.f; }
+	return a.g < b.g;
+}
+
+uint32_t Pathfinder::distance(int x0, int y0, int x1, int y1)
+{
+	uint32_t dx = (uint32_t)std::abs(x1 - x0);
+	uint32_t dy = (uint32_t)std::abs(y1 - y0);
+	uint32_t diagonal = dx < dy ? dx : dy;
+	uint32_t straight = (dx > dy ? dx : dy) - diagonal;
+	return diagonal * DiagonalCost + straight * StraightCost;
+}
+
+void Pathfinder::rebuild()
+{
+	const TileGrid& grid = *m_grid;
+	int width = grid.width();
+	int height = grid.height();
+	m_stride = width + 2;
+	size_t cells = (size_t)m_stride * (height + 2);
+
+	// the border cells stay blocked so a neighbour of any map cell is always inside the arrays
+	m_blocked.assign(cells, 1);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			m_blocked[(size_t)(y + 1) * m_stride + x + 1] = grid.blocksMove(x, y) ? 1 : 0;
+		}
+	}
+
+	if (m_cost.size() != cells)
+	{
+		m_cost.assign(cells, 0);
+		m_parent.assign(cells, 0);
+		m_openedIn.assign(cells, 0);
+		m_closedIn.assign(cells, 0);
+		m_searchId = 0;
+	}
+
+	// Flood fill the free cells. A diagonal step needs both cells beside it to be free,
+	// so cells joined by a diagonal are always joined through a side as well.
+	m_region.assign(cells, 0);
+	uint32_t region = 0;
+	const int offsets[4] = { 1, -1, m_stride, -m_stride };
+	for (uint32_t cell = 0; cell < cells; ++cell)
+	{
+		if (m_blocked[cell] || m_region[cell] != 0) { continue; }
+
+		m_region[cell] = ++region;
+		m_floodStack.push_back(cell);
+		while (!m_floodStack.empty())
+		{
+			uint32_t current = m_floodStack.back();
+			m_floodStack.pop_back();
+			for (int offset : offsets)
+			{
+				uint32_t next = current + offset;
+				if (m_blocked[next] || m_region[next] != 0) { continue; }
+				m_region[next] = region;
+				m_floodStack.push_back(next);
+			}
+		}
+	}
+}
+
+bool Pathfinder::search(uint32_t start, uint32_t goal, Path& out)
+{
+	// the stamps would be ambiguous once the id wraps around, so start the arrays over
+	if (++m_searchId == 0)
+	{
+		std::fill(m_openedIn.begin(), m_openedIn.end(), 0);
+		std::fill(m_closedIn.begin(), m_closedIn.end(), 0);
+		m_searchId = 1;
+	}
+	++m_searches;
+
+	int goalX = (int)(goal % m_stride);
+	int goalY = (int)(goal / m_stride);
+
+	m_open.clear();
+	m_cost[start] = 0;
+	m_parent[start] = start;
+	m_openedIn[start] = m_searchId;
+	m_open.push_back({ distance(start % m_stride, start / m_stride, goalX, goalY), 0, start });
+
+	// the first four neighbours are the sides, the rest are the diagonals between side a and side b
+	const int offsets[8] = { 1, -1, m_stride, -m_stride, 1 + m_stride, 1 - m_stride, -1 + m_stride, -1 - m_stride };
+	const int sideA[8] = { 0, 0, 0, 0, 1, 1, -1, -1 };
+	const int sideB[8] = { 0, 0, 0, 0, m_stride, -m_stride, m_stride, -m_stride };
+
+	while (!m_open.empty())
+	{
+		std::pop_heap(m_open.begin(), m_open.end(), openNodeLess);
+		OpenNode node = m_open.back();
+		m_open.pop_back();
+
+		// a cell can be pushed again when a cheaper way to it is found, skip the stale copies
+		if (m_closedIn[node.cell] == m_searchId) { continue; }
+		m_closedIn[node.cell] = m_searchId;
+		++m_nodesExpanded;
+
+		if (node.cell == goal) { break; }
+
+		for (int i = 0; i < 8; ++i)
+		{
+			uint32_t next = node.cell + offsets[i];
+			if (m_blocked[next]) { continue; }
+
+			bool diagonal = i >= 4;
+			if (diagonal && (m_blocked[node.cell + sideA[i]] || m_blocked[node.cell + sideB[i]])) { continue; }
+			if (m_closedIn[next] == m_searchId) { continue; }
+
+			uint32_t g = node.g + (diagonal ? DiagonalCost : StraightCost);
+			if (m_openedIn[next] == m_searchId && g >= m_cost[next]) { continue; }
+
+			m_openedIn[next] = m_searchId;
+			m_cost[next] = g;
+			m_parent[next] = node.cell;
+			m_open.push_back({ g + distance(next % m_stride, next / m_stride, goalX, goalY), g, next });
+			std::push_heap(m_open.begin(), m_open.end(), openNodeLess);
+		}
+	}
+
+	if (m_closedIn[goal] != m_searchId) { return false; }
+
+	// walk back from the goal then flip the cells into start to goal order, removing the border padding
+	for (uint32_t cell = goal; ; cell = m_parent[cell])
+	{
+		out.push_back({ (int)(cell % m_stride) - 1, (int)(cell / m_stride) - 1 });
+		if (cell == start) { break; }
+	}
+	std::reverse(out.begin(), out.end());
+	return true;
+}
+
+size_t Pathfinder::cacheSlot(uint64_t key) const
+{
+	// Fibonacci hashing spreads neighbouring cells across the table, then probe until the key or an empty slot
+	size_t mask = m_cacheSlots.size() - 1;
+	size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+	while (m_cacheSlots[slot] != NoEntry && m_cacheKeys[slot] != key)
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void Pathfinder::eraseCacheSlot(size_t slot)
+{
+	// Move later entries of the probe run into the hole when the hole lies between their home slot and
+	// where they are, so every key stays reachable from its home slot without passing an empty slot.
+	size_t mask = m_cacheSlots.size() - 1;
+	size_t hole = slot;
+	for (size_t next = (hole + 1) & mask; m_cacheSlots[next] != NoEntry; next = (next + 1) & mask)
+	{
+		size_t home = (size_t)((m_cacheKeys[next] * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			m_cacheKeys[hole] = m_cacheKeys[next];
+			m_cacheSlots[hole] = m_cacheSlots[next];
+			hole = next;
+		}
+	}
+	m_cacheSlots[hole] = NoEntry;
+}
+
+void Pathfinder::unlinkEntry(uint32_t entry)
+{
+	CachedPath& cached = m_cache[entry];
+	if (cached.prev != NoEntry) { m_cache[cached.prev].next = cached.next; }
+	else { m_cacheHead = cached.next; }
+	if (cached.next != NoEntry) { m_cache[cached.next].prev = cached.prev; }
+	else { m_cacheTail = cached.prev; }
+	cached.prev = NoEntry;
+	cached.next = NoEntry;
+}
+
+void Pathfinder::linkFront(uint32_t entry)
+{
+	CachedPath& cached = m_cache[entry];
+	cached.prev = NoEntry;
+	cached.next = m_cacheHead;
+	if (m_cacheHead != NoEntry) { m_cache[m_cacheHead].prev = entry; }
+	m_cacheHead = entry;
+	if (m_cacheTail == NoEntry) { m_cacheTail = entry; }
+}
+
+void Pathfinder::cachePath(uint64_t key, const Path& path)
+{
+	if (m_cacheCapacity == 0) { return; }
+
+	// reuse the least recently used entry once the cache is full so its path keeps its memory
+	uint32_t entry;
+	if (m_cacheUsed >= m_cacheCapacity)
+	{
+		entry = m_cacheTail;
+		eraseCacheSlot(cacheSlot(m_cache[entry].key));
+		unlinkEntry(entry);
+	}
+	else
+	{
+		entry = (uint32_t)m_cacheUsed++;
+	}
+
+	CachedPath& cached = m_cache[entry];
+	cached.key = key;
+	cached.path.assign(path.begin(), path.end());
+	linkFront(entry);
+
+	size_t slot = cacheSlot(key);
+	m_cacheKeys[slot] = key;
+	m_cacheSlots[slot] = entry;
+}
+
+bool Pathfinder::findPath(int startX, int startY, int goalX, int goalY, Path& out)
+{
+	out.clear();
+	if (m_grid == nullptr) { return false; }
+
+	const TileGrid& grid = *m_grid;
+	if (!grid.inBounds(startX, startY) || grid.blocksMove(goalX, goalY)) { return false; }
+
+	if (grid.moveVersion() != m_cacheVersion || m_blocked.empty())
+	{
+		clearCache();
+		rebuild();
+		m_cacheVersion = grid.moveVersion();
+	}
+
+	uint32_t start = (uint32_t)((startY + 1) * m_stride + startX + 1);
+	uint32_t goal = (uint32_t)((goalY + 1) * m_stride + goalX + 1);
+
+	// a blocked start cell has no region of its own, so only compare regions when it is free
+	if (!m_blocked[start] && m_region[start] != m_region[goal]) { return false; }
+
+	uint64_t key = ((uint64_t)start << 32) | goal;
+	if (m_cacheCapacity > 0)
+	{
+		uint32_t entry = m_cacheSlots[cacheSlot(key)];
+		if (entry != NoEntry)
+		{
+			++m_cacheHits;
+			unlinkEntry(entry);
+			linkFront(entry);
+			const Path& path = m_cache[entry].path;
+			out.assign(path.begin(), path.end());
+			return !out.empty();
+		}
+	}
+
+	// failed searches are cached as an empty path so an unreachable goal isn't searched for every frame
+	bool found = search(start, goal, out);
+	cachePath(key, out);
+	return found;
+}
+
+void Pathfinder::clearCache()
+{
+	// the entries keep their paths' memory for the next results
+	std::fill(m_cacheSlots.begin(), m_cacheSlots.end(), NoEntry);
+	m_cacheHead = NoEntry;
+	m_cacheTail = NoEntry;
+	m_cacheUsed = 0;
+}
+
+size_t Pathfinder::cacheHits() const
+{
+	return m_cacheHits;
+}
+
+size_t Pathfinder::searches() const
+{
+	return m_searches;
+}
+
+size_t Pathfinder::nodesExpanded() const
+{
+	return m_nodesExpanded;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "TileGrid.h"
+
+#include <vector>
+#include <cstdint>
+
+typedef std::vector<GridCell> Path;
+
+// A* over a TileGrid with 8 way movement. Diagonal steps are only taken when both cells beside the
+// diagonal are free, so a path never cuts the corner of a blocking tile.
+//
+// The per cell search state lives in arrays the size of the grid that are reused by every search. Each
+// search stamps the cells it touches with its own id instead of clearing the arrays, so once the arrays
+// and the open list have grown to fit the map a search doesn't allocate.
+//
+// Whenever the grid's blocking cells change the pathfinder takes a copy of them with a blocking border
+// around the map, so neighbours can be read without bounds checks. It also labels the connected regions
+// of free cells so a request for a goal that can't be reached fails at once instead of searching every
+// cell the start can reach.
+//
+// Recent results are kept in a least recently used cache keyed on the start and goal cells. The cache is
+// dropped whenever the grid's moveVersion() changes, which happens when any cell starts or stops blocking.
+// Its entries and index are allocated up front and an evicted entry's path keeps its memory, so caching
+// only allocates while the entries are still growing to the length of the paths being found.
+class Pathfinder
+{
+	struct OpenNode
+	{
+		uint32_t f = 0;      // cost so far plus the heuristic
+		uint32_t g = 0;      // cost so far
+		uint32_t cell = 0;
+	};
+
+	static constexpr uint32_t NoEntry = UINT32_MAX;
+
+	// An entry of the path cache, linked into the recently used list by index
+	struct CachedPath
+	{
+		uint64_t key = 0;
+		uint32_t prev = NoEntry;
+		uint32_t next = NoEntry;
+		Path     path;
+	};
+
+	const TileGrid*                                             m_grid = nullptr;
+	int                                                         m_stride = 0;  // width of the padded arrays, the grid width + 2
+	std::vector<uint8_t>                                        m_blocked;     // padded copy of the grid's blockMove bits
+	std::vector<uint32_t>                                       m_region;      // connected region of each padded cell, 0 when blocked
+	std::vector<uint32_t>                                       m_floodStack;
+	std::vector<uint32_t>                                       m_cost;        // best cost found to each padded cell
+	std::vector<uint32_t>                                       m_parent;      // the cell each cell was reached from
+	std::vector<uint32_t>                                       m_openedIn;    // the id of the last search to reach each cell
+	std::vector<uint32_t>                                       m_closedIn;    // the id of the last search to expand each cell
+	std::vector<OpenNode>                                       m_open;        // binary heap ordered by f
+	uint32_t                                                    m_searchId = 0;
+
+	// The cache index is an open addressing table with linear probing, kept at most half full. Evicting an
+	// entry shifts the rest of its probe run back, so the table needs no tombstones.
+	std::vector<CachedPath>                                     m_cache;       // every entry, used or not
+	std::vector<uint64_t>                                       m_cacheKeys;   // key stored in each index slot
+	std::vector<uint32_t>                                       m_cacheSlots;  // entry in each index slot, NoEntry when unused
+	uint32_t                                                    m_cacheHead = NoEntry;  // most recently used
+	uint32_t                                                    m_cacheTail = NoEntry;  // least recently used
+	size_t                                                      m_cacheUsed = 0;
+	size_t                                                      m_cacheCapacity = 256;
+	size_t                                                      m_cacheVersion = 0;
+
+	size_t                                                      m_cacheHits = 0;
+	size_t                                                      m_searches = 0;
+	size_t                                                      m_nodesExpanded = 0;
+
+	static bool openNodeLess(const OpenNode& a, const OpenNode& b);
+	void rebuild();
+	bool search(uint32_t start, uint32_t goal, Path& out);
+	size_t cacheSlot(uint64_t key) const;
+	void eraseCacheSlot(size_t slot);
+	void unlinkEntry(uint32_t entry);
+	void linkFront(uint32_t entry);
+	void cachePath(uint64_t key, const Path& path);
+
+public:
+
+	static constexpr uint32_t StraightCost = 10;
+	static constexpr uint32_t DiagonalCost = 14;
+
+	// Octile distance, the cost of the best path between two cells with nothing in the way.
+	static uint32_t distance(int x0, int y0, int x1, int y1);
+
+	Pathfinder();
+	Pathfinder(const TileGrid& grid, size_t cacheCapacity = 256);
+
+	// Writes the cells from start to goal, both included, into out. Returns false and leaves out empty
+	// when the goal is blocked or can't be reached. The start cell itself may be blocking.
+	bool findPath(int startX, int startY, int goalX, int goalY, Path& out);
+
+	void clearCache();
+
+	size_t cacheHits() const;
+	size_t searches() const;
+	size_t nodesExpanded() const;
+};
\ No newline at end of file
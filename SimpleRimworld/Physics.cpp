@@ -1,34 +1,57 @@
 #include "Physics.h"
 
-Vec2 Physics::GetOverlap(std::shared_ptr<Entity> a, std::shared_ptr<Entity> b)
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define PHYSICS_SIMD 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define PHYSICS_AVX_FUNCTION
+#else
+#define PHYSICS_AVX_FUNCTION __attribute__((target("avx")))
+#endif
+#endif
+
+Vec2 Physics::GetOverlap(const Entity& a, const Entity& b)
 {
-	if (a->has<CBoundingBox>() && b->has<CBoundingBox>())
+	if (a.has<CBoundingBox>() && b.has<CBoundingBox>())
 	{
-		Vec2 delta(abs(b->get<CTransform>().pos.x - a->get<CTransform>().pos.x),
-			abs(b->get<CTransform>().pos.y - a->get<CTransform>().pos.y));
-		float XOverlap = a->get<CBoundingBox>().halfSize.x + b->get<CBoundingBox>().halfSize.x - delta.x;
-		float YOverlap = a->get<CBoundingBox>().halfSize.y + b->get<CBoundingBox>().halfSize.y - delta.y;
+		Vec2 delta(std::abs(b.get<CTransform>().pos.x - a.get<CTransform>().pos.x),
+			std::abs(b.get<CTransform>().pos.y - a.get<CTransform>().pos.y));
+		float XOverlap = a.get<CBoundingBox>().halfSize.x + b.get<CBoundingBox>().halfSize.x - delta.x;
+		float YOverlap = a.get<CBoundingBox>().halfSize.y + b.get<CBoundingBox>().halfSize.y - delta.y;
 		return Vec2(XOverlap, YOverlap);
 	}
 	else { return Vec2(0, 0); }
 }
 
-Vec2 Physics::GetPreviousOverlap(std::shared_ptr<Entity> a, std::shared_ptr<Entity> b)
+Vec2 Physics::GetPreviousOverlap(const Entity& a, const Entity& b)
 {
-	if (a->has<CBoundingBox>() && b->has<CBoundingBox>())
+	if (a.has<CBoundingBox>() && b.has<CBoundingBox>())
 	{
-		Vec2 delta(abs(b->get<CTransform>().pos.x - a->get<CTransform>().prevPos.x),
-			abs(b->get<CTransform>().pos.y - a->get<CTransform>().prevPos.y));
-		float XOverlap = a->get<CBoundingBox>().halfSize.x + b->get<CBoundingBox>().halfSize.x - delta.x;
-		float YOverlap = a->get<CBoundingBox>().halfSize.y + b->get<CBoundingBox>().halfSize.y - delta.y;
+		Vec2 delta(std::abs(b.get<CTransform>().pos.x - a.get<CTransform>().prevPos.x),
+			std::abs(b.get<CTransform>().pos.y - a.get<CTransform>().prevPos.y));
+		float XOverlap = a.get<CBoundingBox>().halfSize.x + b.get<CBoundingBox>().halfSize.x - delta.x;
+		float YOverlap = a.get<CBoundingBox>().halfSize.y + b.get<CBoundingBox>().halfSize.y - delta.y;
 		return Vec2(XOverlap, YOverlap);
 	}
 	else { return Vec2(0, 0); }
 }
 
-bool Physics::IsInside(const Vec2& pos, std::shared_ptr<Entity> e)
+sf::FloatRect Physics::GetBounds(const Entity& e, const Animation& animation)
+{
+	// the same rectangle the sprite's global bounds would be, its origin is the middle of the frame
+	auto& transform = e.get<CTransform>();
+	const Vec2& size = animation.getSize();
+	sf::Transform world;
+	world.translate(transform.pos.x, transform.pos.y).rotate(transform.angle).scale(transform.scale.x, transform.scale.y);
+	return world.transformRect(sf::FloatRect(-size.x / 2.0f, -size.y / 2.0f, size.x, size.y));
+}
+
+bool Physics::IsInside(const Vec2& pos, const Entity& e, const Animation& animation)
 {
-	sf::FloatRect globalBounds = e->get<CAnimation>().animation.getSprite().getGlobalBounds();
+	sf::FloatRect globalBounds = GetBounds(e, animation);
 	if (pos.x > globalBounds.left && pos.x < globalBounds.left + globalBounds.width &&
 		pos.y > globalBounds.top && pos.y < globalBounds.top + globalBounds.height)
 	{
@@ -57,9 +80,9 @@ Intersect Physics::LineIntersect(const Vec2& a, const Vec2& b, const Vec2& c, co
 	}	
 }
 
-bool Physics::EntityIntersect(const Vec2& a, const Vec2& b, std::shared_ptr<Entity> e)
+bool Physics::EntityIntersect(const Vec2& a, const Vec2& b, const Entity& e, const Animation& animation)
 {
-	sf::FloatRect globalBounds = e->get<CAnimation>().animation.getSprite().getGlobalBounds();
+	sf::FloatRect globalBounds = GetBounds(e, animation);
 	Vec2 topLeft = Vec2(globalBounds.left, globalBounds.top);
 	Vec2 topRight = Vec2(globalBounds.left + globalBounds.width, globalBounds.top);
 	Vec2 bottomLeft = Vec2(globalBounds.left, globalBounds.top + globalBounds.height);
@@ -71,4 +94,187 @@ bool Physics::EntityIntersect(const Vec2& a, const Vec2& b, std::shared_ptr<Enti
 	else if (LineIntersect(a, b, bottomLeft, topLeft).intersected)		{ return true; }
 
 	return false;
+}
+
+void BoxArrays::clear()
+{
+	x.clear();
+	y.clear();
+	halfX.clear();
+	halfY.clear();
+}
+
+void BoxArrays::push(const Vec2& center, const Vec2& halfSize)
+{
+	x.push_back(center.x);
+	y.push_back(center.y);
+	halfX.push_back(halfSize.x);
+	halfY.push_back(halfSize.y);
+}
+
+size_t BoxArrays::size() const
+{
+	return x.size();
+}
+
+namespace
+{
+	// The same operations in the same order as GetOverlap, (half a + half b) - |b - a|. The vector versions
+	// below take the absolute value by clearing the sign bit, which is what std::abs does, so every lane
+	// rounds exactly like this.
+	inline float overlapAxis(float centerA, float halfA, float centerB, float halfB)
+	{
+		return halfA + halfB - std::abs(centerB - centerA);
+	}
+
+	void overlapsScalar(const Vec2& center, const Vec2& halfSize, const BoxArrays& boxes, size_t begin, float* overlapX, float* overlapY)
+	{
+		for (size_t i = begin; i < boxes.size(); ++i)
+		{
+			overlapX[i] = overlapAxis(center.x, halfSize.x, boxes.x[i], boxes.halfX[i]);
+			overlapY[i] = overlapAxis(center.y, halfSize.y, boxes.y[i], boxes.halfY[i]);
+		}
+	}
+
+	void pairOverlapsScalar(const BoxArrays& boxes, const BoxPair* pairs, size_t begin, size_t count, float* overlapX, float* overlapY)
+	{
+		for (size_t i = begin; i < count; ++i)
+		{
+			uint32_t a = pairs[i].a;
+			uint32_t b = pairs[i].b;
+			overlapX[i] = overlapAxis(boxes.x[a], boxes.halfX[a], boxes.x[b], boxes.halfX[b]);
+			overlapY[i] = overlapAxis(boxes.y[a], boxes.halfY[a], boxes.y[b], boxes.halfY[b]);
+		}
+	}
+
+#ifdef PHYSICS_SIMD
+	size_t overlapsSSE2(const Vec2& center, const Vec2& halfSize, const BoxArrays& boxes, float* overlapX, float* overlapY)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const __m128 ax = _mm_set1_ps(center.x);
+		const __m128 ay = _mm_set1_ps(center.y);
+		const __m128 ahx = _mm_set1_ps(halfSize.x);
+		const __m128 ahy = _mm_set1_ps(halfSize.y);
+
+		size_t count = boxes.size() & ~(size_t)3;
+		for (size_t i = 0; i < count; i += 4)
+		{
+			__m128 dx = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_loadu_ps(&boxes.x[i]), ax));
+			__m128 dy = _mm_andnot_ps(signMask, _mm_sub_ps(_mm_loadu_ps(&boxes.y[i]), ay));
+			_mm_storeu_ps(overlapX + i, _mm_sub_ps(_mm_add_ps(ahx, _mm_loadu_ps(&boxes.halfX[i])), dx));
+			_mm_storeu_ps(overlapY + i, _mm_sub_ps(_mm_add_ps(ahy, _mm_loadu_ps(&boxes.halfY[i])), dy));
+		}
+		return count;
+	}
+
+	// Pairs point anywhere in the arrays, so each lane is loaded on its own and only the arithmetic is
+	// done four at a time. SSE2 and AVX have no gather, and AVX2's is no faster than this for floats.
+	size_t pairOverlapsSSE2(const BoxArrays& boxes, const BoxPair* pairs, size_t count, float* overlapX, float* overlapY)
+	{
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		const float* x = boxes.x.data();
+		const float* y = boxes.y.data();
+		const float* hx = boxes.halfX.data();
+		const float* hy = boxes.halfY.data();
+
+		size_t batched = count & ~(size_t)3;
+		for (size_t i = 0; i < batched; i += 4)
+		{
+			const BoxPair* p = pairs + i;
+			__m128 ax = _mm_setr_ps(x[p[0].a], x[p[1].a], x[p[2].a], x[p[3].a]);
+			__m128 bx = _mm_setr_ps(x[p[0].b], x[p[1].b], x[p[2].b], x[p[3].b]);
+			__m128 ay = _mm_setr_ps(y[p[0].a], y[p[1].a], y[p[2].a], y[p[3].a]);
+			__m128 by = _mm_setr_ps(y[p[0].b], y[p[1].b], y[p[2].b], y[p[3].b]);
+			__m128 ahx = _mm_setr_ps(hx[p[0].a], hx[p[1].a], hx[p[2].a], hx[p[3].a]);
+			__m128 bhx = _mm_setr_ps(hx[p[0].b], hx[p[1].b], hx[p[2].b], hx[p[3].b]);
+			__m128 ahy = _mm_setr_ps(hy[p[0].a], hy[p[1].a], hy[p[2].a], hy[p[3].a]);
+			__m128 bhy = _mm_setr_ps(hy[p[0].b], hy[p[1].b], hy[p[2].b], hy[p[3].b]);
+
+			__m128 dx = _mm_andnot_ps(signMask, _mm_sub_ps(bx, ax));
+			__m128 dy = _mm_andnot_ps(signMask, _mm_sub_ps(by, ay));
+			_mm_storeu_ps(overlapX + i, _mm_sub_ps(_mm_add_ps(ahx, bhx), dx));
+			_mm_storeu_ps(overlapY + i, _mm_sub_ps(_mm_add_ps(ahy, bhy), dy));
+		}
+		return batched;
+	}
+
+	PHYSICS_AVX_FUNCTION size_t overlapsAVX(const Vec2& center, const Vec2& halfSize, const BoxArrays& boxes, float* overlapX, float* overlapY)
+	{
+		const __m256 signMask = _mm256_set1_ps(-0.0f);
+		const __m256 ax = _mm256_set1_ps(center.x);
+		const __m256 ay = _mm256_set1_ps(center.y);
+		const __m256 ahx = _mm256_set1_ps(halfSize.x);
+		const __m256 ahy = _mm256_set1_ps(halfSize.y);
+
+		size_t count = boxes.size() & ~(size_t)7;
+		for (size_t i = 0; i < count; i += 8)
+		{
+			__m256 dx = _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_loadu_ps(&boxes.x[i]), ax));
+			__m256 dy = _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_loadu_ps(&boxes.y[i]), ay));
+			_mm256_storeu_ps(overlapX + i, _mm256_sub_ps(_mm256_add_ps(ahx, _mm256_loadu_ps(&boxes.halfX[i])), dx));
+			_mm256_storeu_ps(overlapY + i, _mm256_sub_ps(_mm256_add_ps(ahy, _mm256_loadu_ps(&boxes.halfY[i])), dy));
+		}
+
+		// avoid the penalty for switching back to the SSE code the rest of the program is compiled to
+		_mm256_zeroupper();
+		return count;
+	}
+
+	bool cpuHasAVX()
+	{
+#ifdef _MSC_VER
+		// the CPU has AVX and the OS saves the AVX registers on a context switch
+		int info[4];
+		__cpuid(info, 1);
+		bool avx = (info[2] & (1 << 28)) != 0;
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		return avx && osxsave && (_xgetbv(0) & 6) == 6;
+#else
+		return __builtin_cpu_supports("avx");
+#endif
+	}
+
+	SimdLevel bestSimdLevel()
+	{
+		return cpuHasAVX() ? SimdLevel::AVX : SimdLevel::SSE2;
+	}
+#else
+	SimdLevel bestSimdLevel()
+	{
+		return SimdLevel::Scalar;
+	}
+#endif
+
+	SimdLevel simdLevel = bestSimdLevel();
+}
+
+void Physics::GetOverlaps(const Vec2& center, const Vec2& halfSize, const BoxArrays& boxes, float* overlapX, float* overlapY)
+{
+	size_t done = 0;
+#ifdef PHYSICS_SIMD
+	if (simdLevel == SimdLevel::AVX)	   { done = overlapsAVX(center, halfSize, boxes, overlapX, overlapY); }
+	else if (simdLevel == SimdLevel::SSE2) { done = overlapsSSE2(center, halfSize, boxes, overlapX, overlapY); }
+#endif
+	overlapsScalar(center, halfSize, boxes, done, overlapX, overlapY);
+}
+
+void Physics::GetOverlaps(const BoxArrays& boxes, const BoxPair* pairs, size_t count, float* overlapX, float* overlapY)
+{
+	// the pair kernel is bound by its scattered loads, which AVX doesn't make any faster than SSE2
+	size_t done = 0;
+#ifdef PHYSICS_SIMD
+	if (simdLevel != SimdLevel::Scalar) { done = pairOverlapsSSE2(boxes, pairs, count, overlapX, overlapY); }
+#endif
+	pairOverlapsScalar(boxes, pairs, done, count, overlapX, overlapY);
+}
+
+SimdLevel Physics::GetSimdLevel()
+{
+	return simdLevel;
+}
+
+void Physics::SetSimdLevel(SimdLevel level)
+{
+	SimdLevel best = bestSimdLevel();
+	simdLevel = level > best ? best : level;
 }
\ No newline at end of file
@@ -2,21 +2,69 @@
 
 #include "Entity.h"
 
+#include <vector>
+#include <cstdint>
+
 struct Intersect
 {
 	bool intersected = false;
 	Vec2 point;
 };
 
+// Boxes stored as one array per coordinate so the batch overlap functions can load several at once.
+struct BoxArrays
+{
+	std::vector<float> x;      // center
+	std::vector<float> y;
+	std::vector<float> halfX;
+	std::vector<float> halfY;
+
+	void clear();
+	void push(const Vec2& center, const Vec2& halfSize);
+	size_t size() const;
+};
+
+// Two boxes to test against each other, as indices into the same BoxArrays.
+struct BoxPair
+{
+	uint32_t a = 0;
+	uint32_t b = 0;
+};
+
+// The widest vector instructions the batch overlap functions use.
+enum class SimdLevel
+{
+	Scalar,
+	SSE2,
+	AVX
+};
+
 class Physics
 {
 public:
 
 	Physics() {}
 
-	Vec2 static GetOverlap(std::shared_ptr<Entity> a, std::shared_ptr<Entity> b);
-	Vec2 static GetPreviousOverlap(std::shared_ptr<Entity> a, std::shared_ptr<Entity> b);
-	bool static IsInside(const Vec2& pos, std::shared_ptr<Entity> e);
+	Vec2 static GetOverlap(const Entity& a, const Entity& b);
+	Vec2 static GetPreviousOverlap(const Entity& a, const Entity& b);
+	// The area an entity's animation covers when drawn at its transform. Entities only keep the id of
+	// their animation, so the clip is passed in.
+	sf::FloatRect static GetBounds(const Entity& e, const Animation& animation);
+	bool static IsInside(const Vec2& pos, const Entity& e, const Animation& animation);
 	Intersect LineIntersect(const Vec2& a, const Vec2& b, const Vec2& c, const Vec2& d);
-	bool EntityIntersect(const Vec2& a, const Vec2& b, std::shared_ptr<Entity> e);
+	bool EntityIntersect(const Vec2& a, const Vec2& b, const Entity& e, const Animation& animation);
+
+	// Batch versions of GetOverlap that work on many boxes at a time. Each result is exactly the float
+	// GetOverlap gives for the same two boxes, whichever SimdLevel is used. Pass a box's previous
+	// position as the center to get GetPreviousOverlap.
+
+	// Overlap of one box with every box in boxes, written to overlapX[i] and overlapY[i].
+	void static GetOverlaps(const Vec2& center, const Vec2& halfSize, const BoxArrays& boxes, float* overlapX, float* overlapY);
+
+	// Overlap of the two boxes of each pair, such as the candidate pairs from a broad phase.
+	void static GetOverlaps(const BoxArrays& boxes, const BoxPair* pairs, size_t count, float* overlapX, float* overlapY);
+
+	// Starts at the best level the CPU supports. Setting a level the CPU doesn't support uses the best one it does.
+	SimdLevel static GetSimdLevel();
+	void static SetSimdLevel(SimdLevel level);
 };
\ No newline at end of file
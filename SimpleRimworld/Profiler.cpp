@@ -0,0 +1,305 @@
+#include "Profiler.h"
+
+#include "imgui.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+std::vector<Profiler::Frame> Profiler::s_frames(FrameCount);
+size_t                       Profiler::s_current = 0;
+size_t                       Profiler::s_recorded = 0;
+bool                         Profiler::s_inFrame = false;
+bool                         Profiler::s_paused = false;
+uint32_t                     Profiler::s_open[MaxDepth] = {};
+uint32_t                     Profiler::s_depth = 0;
+int                          Profiler::s_selectedFrame = 0;
+std::vector<Profiler::Stats> Profiler::s_stats;
+
+namespace
+{
+	double toMilliseconds(uint64_t nanoseconds)
+	{
+		return nanoseconds / 1000000.0;
+	}
+
+	// the same name always gets the same color in the timeline
+	ImU32 scopeColor(const char* name)
+	{
+		uint32_t hash = 2166136261u;
+		for (const char* c = name; *c; ++c) { hash = (hash ^ (uint8_t)*c) * 16777619u; }
+		return ImColor::HSV((hash % 360) / 360.0f, 0.45f, 0.85f);
+	}
+
+	void writeJsonString(std::ofstream& out, const char* text)
+	{
+		out << '"';
+		for (const char* c = text; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\') { out << '\\'; }
+			out << *c;
+		}
+		out << '"';
+	}
+}
+
+uint64_t Profiler::now()
+{
+	static const auto origin = std::chrono::steady_clock::now();
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void Profiler::beginFrame()
+{
+	if (s_paused) { return; }
+
+	Frame& frame = s_frames[s_current];
+	frame.events.clear();
+	frame.start = now();
+	s_depth = 0;
+	s_inFrame = true;
+}
+
+void Profiler::endFrame()
+{
+	if (!s_inFrame) { return; }
+
+	// close anything still open so every event has an end
+	Frame& frame = s_frames[s_current];
+	frame.end = now();
+	for (ProfileEvent& event : frame.events)
+	{
+		if (event.end == 0) { event.end = frame.end; }
+	}
+
+	s_current = (s_current + 1) % FrameCount;
+	// one slot is always the frame being recorded
+	if (s_recorded < FrameCount - 1) { ++s_recorded; }
+	s_depth = 0;
+	s_inFrame = false;
+}
+
+void Profiler::beginScope(const char* name)
+{
+	if (!s_inFrame) { return; }
+
+	// scopes nested deeper than MaxDepth are counted so they close in order, but not recorded
+	Frame& frame = s_frames[s_current];
+	if (s_depth < MaxDepth)
+	{
+		s_open[s_depth] = (uint32_t)frame.events.size();
+		frame.events.push_back({ name, now(), 0, s_depth });
+	}
+	++s_depth;
+}
+
+void Profiler::endScope()
+{
+	if (!s_inFrame || s_depth == 0) { return; }
+
+	--s_depth;
+	if (s_depth < MaxDepth) { s_frames[s_current].events[s_open[s_depth]].end = now(); }
+}
+
+void Profiler::setPaused(bool paused)
+{
+	if (paused && s_inFrame) { endFrame(); }
+	s_paused = paused;
+}
+
+bool Profiler::isPaused()
+{
+	return s_paused;
+}
+
+bool Profiler::enabled()
+{
+#ifdef PROFILER_DISABLED
+	return false;
+#else
+	return true;
+#endif
+}
+
+const Profiler::Frame* Profiler::frameBack(size_t framesBack)
+{
+	if (framesBack >= s_recorded) { return nullptr; }
+	return &s_frames[(s_current + FrameCount - 1 - framesBack) % FrameCount];
+}
+
+void Profiler::updateStats()
+{
+	for (Stats& stats : s_stats) { stats.samples.clear(); }
+
+	// total time under each name per frame, so a scope entered several times a frame counts once
+	std::vector<double> frameTotals;
+	for (size_t back = 0; back < s_recorded; ++back)
+	{
+		const Frame& frame = *frameBack(back);
+		frameTotals.assign(s_stats.size(), -1);
+		for (const ProfileEvent& event : frame.events)
+		{
+			size_t index = 0;
+			while (index < s_stats.size() && s_stats[index].name != event.name && std::strcmp(s_stats[index].name, event.name) != 0) { ++index; }
+			if (index == s_stats.size())
+			{
+				s_stats.push_back(Stats());
+				s_stats.back().name = event.name;
+				frameTotals.push_back(-1);
+			}
+			if (frameTotals[index] < 0) { frameTotals[index] = 0; }
+			frameTotals[index] += toMilliseconds(event.end - event.start);
+		}
+		for (size_t i = 0; i < frameTotals.size(); ++i)
+		{
+			if (frameTotals[i] >= 0) { s_stats[i].samples.push_back(frameTotals[i]); }
+		}
+	}
+
+	for (Stats& stats : s_stats)
+	{
+		if (stats.samples.empty()) { stats.min = stats.average = stats.p99 = 0; continue; }
+
+		std::sort(stats.samples.begin(), stats.samples.end());
+		double total = 0;
+		for (double sample : stats.samples) { total += sample; }
+		stats.min = stats.samples.front();
+		stats.average = total / stats.samples.size();
+		stats.p99 = stats.samples[(stats.samples.size() * 99 + 99) / 100 - 1];
+	}
+}
+
+void Profiler::drawTimeline(const Frame& frame)
+{
+	const float rowHeight = 20;
+	uint32_t deepest = 0;
+	for (const ProfileEvent& event : frame.events) { deepest = std::max(deepest, event.depth); }
+
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	ImVec2 origin = ImGui::GetCursorScreenPos();
+	float width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+	ImGui::InvisibleButton("timeline", ImVec2(width, rowHeight * (deepest + 1)));
+
+	double frameLength = (double)std::max<uint64_t>(frame.end - frame.start, 1);
+	for (const ProfileEvent& event : frame.events)
+	{
+		float x0 = origin.x + (float)((event.start - frame.start) / frameLength * width);
+		float x1 = origin.x + (float)((event.end - frame.start) / frameLength * width);
+		x1 = std::max(x1, x0 + 1);
+		float y0 = origin.y + event.depth * rowHeight;
+		ImVec2 topLeft(x0, y0);
+		ImVec2 bottomRight(x1, y0 + rowHeight - 1);
+
+		drawList->AddRectFilled(topLeft, bottomRight, scopeColor(event.name));
+		drawList->AddRect(topLeft, bottomRight, IM_COL32(0, 0, 0, 120));
+		if (ImGui::CalcTextSize(event.name).x < x1 - x0 - 6)
+		{
+			drawList->AddText(ImVec2(x0 + 3, y0 + 3), IM_COL32(0, 0, 0, 255), event.name);
+		}
+		if (ImGui::IsMouseHoveringRect(topLeft, bottomRight))
+		{
+			ImGui::SetTooltip("%s\n%.3f ms", event.name, toMilliseconds(event.end - event.start));
+		}
+	}
+}
+
+bool Profiler::exportChromeTrace(const std::string& path)
+{
+	std::ofstream out(path);
+	if (!out) { return false; }
+
+	// complete events ("ph":"X") with times in microseconds, oldest frame first
+	out << std::fixed << std::setprecision(3);
+	out << "{\"traceEvents\":[";
+	bool first = true;
+	for (size_t back = s_recorded; back-- > 0;)
+	{
+		const Frame& frame = *frameBack(back);
+		out << (first ? "\n" : ",\n") << "{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << frame.start / 1000.0
+			<< ",\"dur\":" << (frame.end - frame.start) / 1000.0 << "}";
+		first = false;
+
+		for (const ProfileEvent& event : frame.events)
+		{
+			out << ",\n{\"name\":";
+			writeJsonString(out, event.name);
+			out << ",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+		}
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return out.good();
+}
+
+void Profiler::drawPanel(bool* open)
+{
+	if (!ImGui::Begin("Profiler", open))
+	{
+		ImGui::End();
+		return;
+	}
+
+	if (!enabled())
+	{
+		ImGui::Text("The profiler is compiled out (PROFILER_DISABLED).");
+		ImGui::End();
+		return;
+	}
+
+	static std::string exportMessage;
+	bool paused = s_paused;
+	if (ImGui::Checkbox("Pause", &paused)) { setPaused(paused); }
+	ImGui::SameLine();
+	if (ImGui::Button("Export Chrome trace"))
+	{
+		exportMessage = exportChromeTrace("profile_trace.json") ? "Wrote profile_trace.json" : "Could not write profile_trace.json";
+	}
+	if (!exportMessage.empty()) { ImGui::SameLine(); ImGui::TextUnformatted(exportMessage.c_str()); }
+
+	if (s_recorded == 0)
+	{
+		ImGui::Text("No frames recorded yet.");
+		ImGui::End();
+		return;
+	}
+
+	// frame times, oldest on the left
+	float frameTimes[FrameCount];
+	float longest = 0;
+	for (size_t i = 0; i < s_recorded; ++i)
+	{
+		const Frame& frame = *frameBack(s_recorded - 1 - i);
+		frameTimes[i] = (float)toMilliseconds(frame.end - frame.start);
+		longest = std::max(longest, frameTimes[i]);
+	}
+	ImGui::PlotHistogram("##frames", frameTimes, (int)s_recorded, 0, "frame ms", 0, longest * 1.1f, ImVec2(-1, 60));
+
+	s_selectedFrame = std::min(s_selectedFrame, (int)s_recorded - 1);
+	ImGui::SliderInt("Frames back", &s_selectedFrame, 0, (int)s_recorded - 1);
+	const Frame& selected = *frameBack((size_t)s_selectedFrame);
+	ImGui::Text("Frame: %.3f ms, %zu scopes", toMilliseconds(selected.end - selected.start), selected.events.size());
+	drawTimeline(selected);
+
+	updateStats();
+	if (ImGui::BeginTable("stats", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+	{
+		ImGui::TableSetupColumn("Scope");
+		ImGui::TableSetupColumn("Min ms");
+		ImGui::TableSetupColumn("Avg ms");
+		ImGui::TableSetupColumn("P99 ms");
+		ImGui::TableHeadersRow();
+		for (const Stats& stats : s_stats)
+		{
+			if (stats.samples.empty()) { continue; }
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.name);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.min);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.average);
+			ImGui::TableNextColumn(); ImGui::Text("%.3f", stats.p99);
+		}
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Define PROFILER_DISABLED to compile every PROFILE_ macro out. The Profiler class is still there so the
+// panel can say it is off, but no timer is ever read.
+#ifndef PROFILER_DISABLED
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILER_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_BEGIN_FRAME() Profiler::beginFrame()
+#define PROFILE_END_FRAME() Profiler::endFrame()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_BEGIN_FRAME()
+#define PROFILE_END_FRAME()
+#endif
+
+struct ProfileEvent
+{
+	const char* name = "";
+	uint64_t    start = 0;   // nanoseconds since the profiler started
+	uint64_t    end = 0;
+	uint32_t    depth = 0;   // how many scopes were open around this one
+};
+
+// Collects the time spent in named scopes on the main thread. Each frame's scopes are kept in a ring
+// buffer of the last FrameCount frames, whose slots are reused so recording doesn't allocate once the
+// buffer has warmed up.
+//
+// The panel shows the frame times, a timeline of the scopes in one frame with nested scopes stacked
+// under the ones around them, and the min, average and 99th percentile time of every scope name over
+// the frames in the buffer. A capture can be written out as Chrome trace JSON and opened in
+// chrome://tracing or Perfetto.
+//
+// Scope names are kept as pointers, so they have to be string literals or otherwise outlive the buffer.
+class Profiler
+{
+public:
+
+	static constexpr size_t FrameCount = 240;
+	static constexpr size_t MaxDepth = 32;
+
+private:
+
+	struct Frame
+	{
+		uint64_t                  start = 0;
+		uint64_t                  end = 0;
+		std::vector<ProfileEvent> events;    // in the order the scopes opened
+	};
+
+	struct Stats
+	{
+		const char*         name = "";
+		double              min = 0;
+		double              average = 0;
+		double              p99 = 0;
+		std::vector<double> samples;     // total milliseconds in the scope in each frame it ran
+	};
+
+	static std::vector<Frame>  s_frames;
+	static size_t              s_current;       // slot being recorded
+	static size_t              s_recorded;      // frames finished, capped at FrameCount - 1
+	static bool                s_inFrame;
+	static bool                s_paused;
+	static uint32_t            s_open[MaxDepth];
+	static uint32_t            s_depth;
+	static int                 s_selectedFrame;  // how many frames back the timeline shows
+	static std::vector<Stats>  s_stats;
+
+	static const Frame* frameBack(size_t framesBack);
+	static void updateStats();
+	static void drawTimeline(const Frame& frame);
+
+public:
+
+	// nanoseconds since the first call
+	static uint64_t now();
+
+	static void beginFrame();
+	static void endFrame();
+	static void beginScope(const char* name);
+	static void endScope();
+
+	// Stops recording new frames so the buffer can be looked at, the scopes still run but aren't kept.
+	static void setPaused(bool paused);
+	static bool isPaused();
+	static bool enabled();
+
+	// Writes every frame in the buffer as Chrome trace events. Returns false if the file can't be written.
+	static bool exportChromeTrace(const std::string& path);
+
+	static void drawPanel(bool* open = nullptr);
+};
+
+class ProfileScope
+{
+public:
+
+	ProfileScope(const char* name) { Profiler::beginScope(name); }
+	~ProfileScope() { Profiler::endScope(); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator = (const ProfileScope&) = delete;
+};
\ No newline at end of file
@@ -1,17 +1,29 @@
 #include "Scene.h"
 #include "GameEngine.h"
 
+#include <cmath>
+#include <algorithm>
+
 Scene::Scene()
+	: m_visibleSprites(m_entityManager.frameArena())
+	, m_animatedSprites(m_entityManager.frameArena())
 {
 
 }
 
 Scene::Scene(GameEngine* gameEngine)
 	: m_game(gameEngine)
+	, m_visibleSprites(m_entityManager.frameArena())
+	, m_animatedSprites(m_entityManager.frameArena())
 {
 
 }
 
+void Scene::beginFrame()
+{
+	m_entityManager.frameArena().reset();
+}
+
 void Scene::setPaused(bool paused)
 {
 	m_paused = paused;
@@ -32,14 +44,80 @@ size_t Scene::currentFrame() const
 	return m_currentFrame;
 }
 
+bool Scene::isPaused() const
+{
+	return m_paused;
+}
+
+bool Scene::fixedTimestep() const
+{
+	return m_fixedTimestep;
+}
+
+void Scene::setInterpolation(float alpha)
+{
+	m_interpolation = alpha;
+}
+
+void Scene::collectVisibleSprites(EntityHandle skip)
+{
+	// last frame's lists were released with the arena, so start new ones sized for every animated entity
+	FrameArena& arena = m_entityManager.frameArena();
+	size_t animated = m_entityManager.getComponents<CAnimation>().size();
+	m_visibleSprites = ArenaVector<VisibleSprite>(arena);
+	m_animatedSprites = ArenaVector<size_t>(arena);
+	m_visibleSprites.reserve(animated);
+	m_animatedSprites.reserve(animated);
+
+	const Assets& assets = m_game->assets();
+	const sf::View& view = m_game->window().getView();
+	sf::Vector2f center = view.getCenter();
+	sf::Vector2f halfSize = view.getSize() / 2.0f;
+
+	m_entityManager.view<CTransform, CAnimation>().each([&](Entity& e, const CTransform& transform, const CAnimation& animation)
+	{
+		if (e.handle() == skip) { return; }
+
+		const Animation& clip = assets.getAnimation(animation.id);
+		if (!clip.getTexture()) { return; }
+
+		// whatever its rotation the sprite stays within its clip's radius of its origin
+		Vec2 pos = renderPosition(transform);
+		float reach = clip.getRadius() * std::max(std::abs(transform.scale.x), std::abs(transform.scale.y));
+		if (std::abs(pos.x - center.x) > halfSize.x + reach || std::abs(pos.y - center.y) > halfSize.y + reach) { return; }
+
+		if (clip.getSpeed() != 0) { m_animatedSprites.push_back(m_visibleSprites.size()); }
+		m_visibleSprites.push_back({ &e, &clip, 0, animation.startFrame, animation.repeat });
+	});
+
+	for (size_t i : m_animatedSprites)
+	{
+		VisibleSprite& sprite = m_visibleSprites[i];
+		sprite.frame = sprite.clip->frameAt(m_currentFrame - sprite.startFrame, sprite.repeat);
+	}
+}
+
+Vec2 Scene::renderPosition(const CTransform& transform) const
+{
+	if (!m_fixedTimestep) { return transform.pos; }
+	return transform.prevPos + (transform.pos - transform.prevPos) * m_interpolation;
+}
+
 const ActionMap& Scene::getActionMap() const
 {
 	return m_actionMap;
 }
 
-void Scene::registerAction(int keyCode, const std::string& name)
+ActionId Scene::keyAction(int keyCode) const
 {
-	m_actionMap[keyCode] = name;
+	if (keyCode < 0 || keyCode >= (int)m_actionMap.size()) { return ActionId::None; }
+	return m_actionMap[keyCode];
+}
+
+void Scene::registerAction(int keyCode, ActionId action)
+{
+	if (keyCode < 0 || keyCode >= (int)m_actionMap.size()) { return; }
+	m_actionMap[keyCode] = action;
 }
 
 bool Scene::hasEnded() const
@@ -47,6 +125,16 @@ bool Scene::hasEnded() const
 	return m_hasEnded;
 }
 
+const SystemTimings& Scene::systemTimings() const
+{
+	return m_systemTimings;
+}
+
+void Scene::resetSystemTimings()
+{
+	m_systemTimings.clear();
+}
+
 void Scene::drawLine(const Vec2& p1, const Vec2& p2)
 {
 	sf::Vertex line[] =
@@ -62,6 +150,7 @@ void Scene::simulate(const size_t frames)
 	for (size_t i = 0; i < frames; i++)
 	{
 		update();
+		m_currentFrame++;
 	}
 }
 
@@ -2,12 +2,38 @@
 
 #include "Action.h"
 #include "EntityManager.h"
+#include "Profiler.h"
 
+#include <SFML/Window/Keyboard.hpp>
+
+#include <array>
 #include <memory>
+#include <chrono>
+#include <cstring>
 
 class GameEngine;
 
-typedef std::map<int, std::string> ActionMap;
+// the action each key is bound to, indexed by key code
+typedef std::array<ActionId, sf::Keyboard::KeyCount> ActionMap;
+
+struct SystemTiming
+{
+	const char* name = "";
+	double      seconds = 0;  // total time spent in the system
+	size_t      calls = 0;
+};
+
+typedef std::vector<SystemTiming> SystemTimings;
+
+// An entity on screen this frame with the clip and frame it is drawn with.
+struct VisibleSprite
+{
+	Entity*          entity = nullptr;
+	const Animation* clip = nullptr;
+	size_t           frame = 0;
+	uint32_t         startFrame = 0;  // copied from the entity's CAnimation for working out the frame
+	bool             repeat = false;
+};
 
 class Scene
 {
@@ -16,14 +42,49 @@ protected:
 
 	GameEngine*   m_game = nullptr;
 	EntityManager m_entityManager;
-	ActionMap     m_actionMap;
+	ActionMap     m_actionMap = {};
 	bool          m_paused = false;
 	bool          m_hasEnded = false;
 	size_t        m_currentFrame = 0;
+	bool          m_fixedTimestep = false;  // updated in fixed ticks instead of once per drawn frame
+	float         m_interpolation = 1.0f;   // how far between the last two ticks the frame being drawn is
+	SystemTimings m_systemTimings;
+	ArenaVector<VisibleSprite> m_visibleSprites;  // filled by collectVisibleSprites() every frame, in the frame arena
+	ArenaVector<size_t>        m_animatedSprites; // the visible sprites whose clip has more than one frame
 	
 	virtual void onEnd() = 0;
 	void setPaused(bool paused);
 
+	// Fills m_visibleSprites with the animated entities whose sprite can reach into the view, except skip.
+	// The lists live in the frame arena, so they are only valid until the next frame begins.
+	// Frames are only worked out for what is on screen: a clip with one frame is always on it and
+	// the others are evaluated together once culling is done, from how long each has been playing.
+	void collectVisibleSprites(EntityHandle skip = EntityHandle());
+
+	// Runs a system and adds the time it took to the timings under the given name. The name is kept
+	// as a pointer, so pass a string literal.
+	template <typename F>
+	void timeSystem(const char* name, F&& system)
+	{
+		PROFILE_SCOPE(name);
+		auto start = std::chrono::steady_clock::now();
+		system();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		SystemTiming* timing = nullptr;
+		for (size_t i = 0; i < m_systemTimings.size(); ++i)
+		{
+			if (m_systemTimings[i].name == name || std::strcmp(m_systemTimings[i].name, name) == 0) { timing = &m_systemTimings[i]; break; }
+		}
+		if (!timing)
+		{
+			m_systemTimings.push_back({ name });
+			timing = &m_systemTimings.back();
+		}
+		timing->seconds += seconds;
+		timing->calls++;
+	}
+
 public:
 
 	Scene();
@@ -33,15 +94,29 @@ public:
 	virtual void sDoAction(const Action& action) = 0;
 	virtual void sRender() = 0;
 
+	// Called by the engine at the start of every drawn frame, releases the frame arena.
+	void beginFrame();
+
 	virtual void doAction(const Action& action);
 	void simulate(const size_t frames);
-	void registerAction(int inputKey, const std::string& actionName);
+	void registerAction(int inputKey, ActionId action);
 
 	size_t width() const;
 	size_t height() const;
 	size_t currentFrame() const;
+	bool isPaused() const;
+
+	bool fixedTimestep() const;
+	void setInterpolation(float alpha);
+
+	// Where to draw an entity, between its position at the last two ticks. Scenes without a fixed
+	// timestep are drawn at the position itself.
+	Vec2 renderPosition(const CTransform& transform) const;
 
 	bool hasEnded() const;
+	const SystemTimings& systemTimings() const;
+	void resetSystemTimings();
 	const ActionMap& getActionMap() const;
+	ActionId keyAction(int keyCode) const;  // ActionId::None for unbound keys
 	void drawLine(const Vec2& p1, const Vec2& p2);
 };
\ No newline at end of file
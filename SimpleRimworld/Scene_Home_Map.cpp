@@ -13,20 +13,76 @@ Scene_Home_Map::Scene_Home_Map(GameEngine* gameEngine, const std::string& levelP
 	: Scene(gameEngine)
 	, m_levelPath(levelPath)
 {
+	m_fixedTimestep = true;
 	init(m_levelPath);
 }
 
 void Scene_Home_Map::init(const std::string& levelPath)
 {
-	
+	m_gridText.setCharacterSize(12);
+	m_gridText.setFont(m_game->assets().getFont(m_game->assets().fontId("Tech")));
+
+	registerAction(sf::Keyboard::Space, ActionId::Pause);
+	registerAction(sf::Keyboard::Num1, ActionId::SpeedNormal);
+	registerAction(sf::Keyboard::Num2, ActionId::SpeedFast);
+	registerAction(sf::Keyboard::Num3, ActionId::SpeedSuperfast);
+	registerAction(sf::Keyboard::Num4, ActionId::SpeedUltra);
+
+	loadLevel(levelPath);
+
+	// only records when the game was started with --record
+	m_game->beginRecording(this, levelPath);
 }
 
 void Scene_Home_Map::loadLevel(const std::string& filename)
 {
-	
+	m_entityManager = EntityManager();
+	m_tileTag = m_entityManager.registerTag("Tile");
+	m_decorationTag = m_entityManager.registerTag("Decoration");
+	m_spriteBatch.clear();
+	m_tileGrid.resize(0, 0);
+
+	std::ifstream file(filename);
+	if (!file) { std::cerr << "Failed to open file " << filename; }
+
+	// Tiles and decorations never move, so besides their entity each one is recorded in the tile grid.
+	// Systems that only need to know whether a cell blocks movement or vision read the grid instead of the entities.
+	// Each line's animation name is looked up once and only its id is kept.
+	std::string str, animationName;
+	while (file >> str)
+	{
+		if (str == "Tile" || str == "Decoration")
+		{
+			auto& entity = m_entityManager.addEntity(str);
+			int gridX, gridY;
+			file >> animationName >> gridX >> gridY;
+			AnimationId animation = m_game->assets().animationId(animationName);
+			if (animation.isValid()) { entity.add<CAnimation>(animation, currentFrame(), true); }
+			else { std::cerr << "Unknown animation " << animationName << std::endl; }
+			entity.add<CTransform>(m_tileGrid.cellCenter(gridX, gridY));
+
+			bool blockMove = false, blockVision = false;
+			if (str == "Tile")
+			{
+				float bbPosX, bbPosY, bbOffsetX, bbOffsetY, bbWidth, bbHeight;
+				file >> bbPosX >> bbPosY >> bbOffsetX >> bbOffsetY
+					>> bbWidth >> bbHeight >> blockMove >> blockVision;
+				entity.add<CBoundingBox>(Vec2(bbPosX, bbPosY), Vec2(bbOffsetX, bbOffsetY),
+					Vec2(bbWidth, bbHeight), blockMove, blockVision);
+			}
+
+			if (!m_tileGrid.set(gridX, gridY, entity.handle(), animation, blockMove, blockVision))
+			{
+				std::cerr << str << " outside the map at " << gridX << " " << gridY << std::endl;
+				entity.destroy();
+			}
+		}
+		else { std::cout << "Invalid entity type: " + str << " name:"; }
+	}
+	m_tileGrid.fitToContents();
 }
 
-std::shared_ptr<Entity> Scene_Home_Map::player()
+Entity* Scene_Home_Map::player()
 {
 	return nullptr;
 }
@@ -38,12 +94,21 @@ void Scene_Home_Map::spawnPlayer()
 
 void Scene_Home_Map::update()
 {
-
+	timeSystem("EntityManager", [&] { m_entityManager.update(); });
+	timeSystem("Movement", [&] { sMovement(); });
+	timeSystem("AI", [&] { sAI(); });
+	timeSystem("Collision", [&] { sCollision(); });
+	timeSystem("Animation", [&] { sAnimation(); });
 }
 
 void Scene_Home_Map::sMovement()
 {
-
+	// prevPos is kept one tick behind so sRender can draw between the two
+	m_entityManager.view<CTransform>().each([](Entity&, CTransform& transform)
+	{
+		transform.prevPos = transform.pos;
+		transform.pos += transform.velocity;
+	});
 }
 
 void Scene_Home_Map::sAI()
@@ -63,12 +128,22 @@ void Scene_Home_Map::sCollision()
 
 void Scene_Home_Map::sDoAction(const Action& action)
 {
-	
+	if (action.type() != ActionType::Start) { return; }
+
+	switch (action.id())
+	{
+	case ActionId::Pause:		   { setPaused(!m_paused); break; }
+	case ActionId::SpeedNormal:	   { m_game->setSimulationSpeed(GameEngine::NormalSpeed); break; }
+	case ActionId::SpeedFast:	   { m_game->setSimulationSpeed(GameEngine::FastSpeed); break; }
+	case ActionId::SpeedSuperfast: { m_game->setSimulationSpeed(GameEngine::SuperfastSpeed); break; }
+	case ActionId::SpeedUltra:	   { m_game->setSimulationSpeed(GameEngine::UltraSpeed); break; }
+	default: break;
+	}
 }
 
 void Scene_Home_Map::sAnimation()
 {
-	
+	// nothing to step, frames are worked out from the scene frame when they are drawn (collectVisibleSprites)
 }
 
 void Scene_Home_Map::sCamera()
@@ -83,7 +158,13 @@ void Scene_Home_Map::onEnd()
 
 void Scene_Home_Map::sGui()
 {
-	
+	ImGui::Begin("Speed");
+	ImGui::Text("Speed: %s", m_paused ? "paused" : (std::to_string(m_game->getSimulationSpeed()) + "x").c_str());
+	ImGui::Text("Ticks per second: %.0f (%d at 1x)", m_game->getTicksPerSecond(), m_game->getTickRate());
+	ImGui::Text("Tick: %zu", m_currentFrame);
+	ImGui::Text("Draw calls: %zu (%zu batches)", m_spriteBatch.drawCalls(), m_spriteBatch.batchCount());
+	ImGui::Text("Sprites: %zu, %zu quads rebuilt", m_spriteBatch.spritesAdded(), m_spriteBatch.quadsRebuilt());
+	ImGui::End();
 }
 
 void Scene_Home_Map::sRender()
@@ -91,53 +172,47 @@ void Scene_Home_Map::sRender()
 	if (!m_paused) { m_game->window().clear(sf::Color(252, 216, 168)); }
 	else { m_game->window().clear(sf::Color(50, 50, 150)); }
 
-	sf::RectangleShape tick({ 1.0f, 6.0f });
-	tick.setFillColor(sf::Color::Black);
+	// sprites and rectangles go through the batch, tiles under decorations under everything else
+	m_spriteBatch.begin();
 
 	if (m_drawTextures)
 	{
-		for (auto& e : m_entityManager.getEntities())
+		// Only what is on screen is animated and drawn. Entities only know which clip they play and since
+		// when, the sprite is made here and the batch keeps the quad it turns into, so one sprite does for
+		// every entity.
+		collectVisibleSprites();
+		sf::Sprite sprite;
+		for (const VisibleSprite& visible : m_visibleSprites)
 		{
-			auto& transform = e->get<CTransform>();
-			sf::Color c = sf::Color::White;
-			if (e->has<CAnimation>())
-			{
-				auto& animation = e->get<CAnimation>().animation;
-				animation.getSprite().setRotation(transform.angle);
-				animation.getSprite().setPosition(transform.pos.x, transform.pos.y);
-				animation.getSprite().setScale(transform.scale.x, transform.scale.y);
-				animation.getSprite().setColor(c);
-				m_game->window().draw(animation.getSprite());
-			}
+			Entity& e = *visible.entity;
+			auto& transform = e.get<CTransform>();
+			visible.clip->applyFrame(sprite, visible.frame);
+
+			sprite.setRotation(transform.angle);
+			Vec2 pos = renderPosition(transform);
+			sprite.setPosition(pos.x, pos.y);
+			sprite.setScale(transform.scale.x, transform.scale.y);
+			sprite.setColor(sf::Color::White);
+			int layer = e.tagId() == m_tileTag ? 0 : (e.tagId() == m_decorationTag ? 1 : 2);
+			m_spriteBatch.add(e.handle(), layer, sprite);
 		}
 
 		// draw entity health bars
-		for (auto& e : m_entityManager.getEntities())
+		for (auto& e : m_entityManager.view<CTransform, CHealth>())
 		{
-			auto& transform = e->get<CTransform>();
-			if (e->has<CHealth>())
+			auto& transform = e.get<CTransform>();
+			auto& h = e.get<CHealth>();
+			Vec2 pos = renderPosition(transform);
+			sf::FloatRect bar(pos.x - 32, pos.y - 48, 64, 6);
+			m_spriteBatch.addRect(bar, sf::Color(96, 96, 96));
+			m_spriteBatch.addRect(bar, sf::Color::Black, 2);
+
+			float ratio = (float)h.current / h.max;
+			m_spriteBatch.addRect(sf::FloatRect(bar.left, bar.top, bar.width * ratio, bar.height), sf::Color(255, 0, 0));
+
+			for (int i = 0; i < h.max; i++)
 			{
-				auto& h = e->get<CHealth>();
-				Vec2 size(64, 6);
-				sf::RectangleShape rect({ size.x, size.y });
-				rect.setPosition(transform.pos.x - 32, transform.pos.y - 48);
-				rect.setFillColor(sf::Color(96, 96, 96));
-				rect.setOutlineColor(sf::Color::Black);
-				rect.setOutlineThickness(2);
-				m_game->window().draw(rect);
-
-				float ratio = (float)h.current / h.max;
-				size.x *= ratio;
-				rect.setSize({ size.x, size.y });
-				rect.setFillColor(sf::Color(255, 0, 0));
-				rect.setOutlineThickness(0);
-				m_game->window().draw(rect);
-
-				for (int i = 0; i < h.max; i++)
-				{
-					tick.setPosition(rect.getPosition() + sf::Vector2f((float)(i * 64 / h.max), 0));
-					m_game->window().draw(tick);
-				}
+				m_spriteBatch.addRect(sf::FloatRect(bar.left + (float)(i * 64 / h.max), bar.top, 1, 6), sf::Color::Black);
 			}
 		}
 	}
@@ -145,31 +220,24 @@ void Scene_Home_Map::sRender()
 	// draw collision boxes
 	if (m_drawCollision)
 	{
-		sf::CircleShape dot(4);
-		dot.setOrigin(4, 4);
-		dot.setFillColor(sf::Color::Black);
-		for (auto& e : m_entityManager.getEntities())
+		for (auto& e : m_entityManager.view<CTransform, CBoundingBox>())
 		{
-			if (e->has<CBoundingBox>())
-			{
-				auto& box = e->get<CBoundingBox>();
-				auto& transform = e->get<CTransform>();
-				sf::RectangleShape rect;
-				rect.setSize(sf::Vector2f(box.size.x - 1, box.size.y - 1));
-				rect.setOrigin(sf::Vector2f(box.halfSize.x, box.halfSize.y));
-				rect.setPosition(transform.pos.x, transform.pos.y);
-				rect.setFillColor(sf::Color(0, 0, 0, 0));
-
-				if (box.blockMove && box.blockVision) { rect.setOutlineColor(sf::Color::Black); }
-				if (box.blockMove && !box.blockVision) { rect.setOutlineColor(sf::Color::Blue); }
-				if (!box.blockMove && box.blockVision) { rect.setOutlineColor(sf::Color::Red); }
-				if (!box.blockMove && !box.blockVision) { rect.setOutlineColor(sf::Color::White); }
-				rect.setOutlineThickness(1);
-				m_game->window().draw(rect);
-			}
+			auto& box = e.get<CBoundingBox>();
+			auto& transform = e.get<CTransform>();
+			Vec2 pos = renderPosition(transform);
+			sf::FloatRect rect(pos.x - box.halfSize.x, pos.y - box.halfSize.y, box.size.x - 1, box.size.y - 1);
+
+			sf::Color color = sf::Color::White;
+			if (box.blockMove && box.blockVision) { color = sf::Color::Black; }
+			if (box.blockMove && !box.blockVision) { color = sf::Color::Blue; }
+			if (!box.blockMove && box.blockVision) { color = sf::Color::Red; }
+			m_spriteBatch.addRect(rect, color, 1);
 		}
 	}
 
+	m_spriteBatch.end();
+	m_spriteBatch.draw(m_game->window());
+
 	if (m_drawGrid)
 	{
 		float leftX = m_game->window().getView().getCenter().x - (float)width() / 2;
@@ -196,5 +264,6 @@ void Scene_Home_Map::sRender()
 		}
 	}
 
+	sGui();
 	ImGui::SFML::Render(m_game->window());
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Scene.h"
+#include "TileGrid.h"
+#include "SpriteBatch.h"
 
 class Scene_Home_Map : public Scene
 {
@@ -12,7 +14,7 @@ class Scene_Home_Map : public Scene
 
 protected:
 
-	std::shared_ptr<Entity>  m_block;
+	EntityHandle             m_block;
 	std::string              m_levelPath;
 	std::string				 m_lastAction;
 	PlayerConfig             m_playerConfig;
@@ -21,6 +23,10 @@ protected:
 	bool                     m_drawGrid = false;
 	const Vec2               m_gridSize = { 64, 64 };
 	sf::Text                 m_gridText;
+	TagId                    m_tileTag = 0;        // resolved when the level loads so drawing doesn't look names up
+	TagId                    m_decorationTag = 0;
+	TileGrid                 m_tileGrid = TileGrid(0, 0, m_gridSize);
+	SpriteBatch              m_spriteBatch;
 
 	void init(const std::string& levelPath);
 	void loadLevel(const std::string& filename);
@@ -28,7 +34,7 @@ protected:
 	void onEnd();
 	void update();
 	void spawnPlayer();
-	std::shared_ptr<Entity> player();
+	Entity* player();
 	void sDoAction(const Action& action);
 
 	void sMovement();
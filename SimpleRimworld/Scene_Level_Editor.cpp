@@ -10,6 +10,7 @@
 #include <fstream>
 #include <sstream>
 #include <cmath>
+#include <utility>
 
 Scene_Level_Editor::Scene_Level_Editor(GameEngine* gameEngine, const std::string& levelPath)
 	: Scene(gameEngine)
@@ -21,18 +22,18 @@ Scene_Level_Editor::Scene_Level_Editor(GameEngine* gameEngine, const std::string
 void Scene_Level_Editor::init()
 {
 	m_gridText.setCharacterSize(12);
-	m_gridText.setFont(m_game->assets().getFont("Tech"));
-
-	registerAction(sf::Keyboard::T, "TOGGLE_TEXTURE");
-	registerAction(sf::Keyboard::C, "TOGGLE_COLLISION");
-	registerAction(sf::Keyboard::G, "TOGGLE_GRID");
-	registerAction(sf::Keyboard::W, "UP");
-	registerAction(sf::Keyboard::S, "DOWN");
-	registerAction(sf::Keyboard::A, "LEFT");
-	registerAction(sf::Keyboard::D, "RIGHT");
-	registerAction(sf::Keyboard::E, "ROTATE_CLOCKWISE");
-	registerAction(sf::Keyboard::Q, "ROTATE_COUNTERCLOCKWISE");
-	registerAction(sf::Keyboard::Escape, "QUIT");
+	m_gridText.setFont(m_game->assets().getFont(m_game->assets().fontId("Tech")));
+
+	registerAction(sf::Keyboard::T, ActionId::ToggleTexture);
+	registerAction(sf::Keyboard::C, ActionId::ToggleCollision);
+	registerAction(sf::Keyboard::G, ActionId::ToggleGrid);
+	registerAction(sf::Keyboard::W, ActionId::Up);
+	registerAction(sf::Keyboard::S, ActionId::Down);
+	registerAction(sf::Keyboard::A, ActionId::Left);
+	registerAction(sf::Keyboard::D, ActionId::Right);
+	registerAction(sf::Keyboard::E, ActionId::RotateClockwise);
+	registerAction(sf::Keyboard::Q, ActionId::RotateCounterclockwise);
+	registerAction(sf::Keyboard::Escape, ActionId::Quit);
 
 	std::ifstream file("config.txt");
 	std::string str;
@@ -52,6 +53,12 @@ void Scene_Level_Editor::init()
 void Scene_Level_Editor::loadLevel(const std::string& filename)
 {
 	m_entityManager = EntityManager();
+	m_tileTag = m_entityManager.registerTag("Tile");
+	m_decorationTag = m_entityManager.registerTag("Decoration");
+	m_spriteBatch.clear();
+	m_entityBeingDragged = EntityHandle();
+	m_spatialHash.clear();
+	m_tileGrid.resize(0, 0);
 
 	std::ifstream file(filename);
 	if (!file) { std::cerr << "Failed to open file " << filename; }
@@ -61,41 +68,58 @@ void Scene_Level_Editor::loadLevel(const std::string& filename)
 	{
 		if (str == "Tile")
 		{
-			std::shared_ptr<Entity> entity;
-			entity = m_entityManager.addEntity(str);
+			auto& entity = m_entityManager.addEntity(str);
 			file >> str;
-			entity->add<CAnimation>(m_game->assets().getAnimation(str), true);
+			AnimationId animation = m_game->assets().animationId(str);
+			if (animation.isValid()) { entity.add<CAnimation>(animation, currentFrame(), true); }
+			else { std::cerr << "Unknown animation " << str << std::endl; }
 
 			int gridX, gridY;
 			file >> gridX >> gridY;
 			float x = gridX * m_gridSize.x + (m_gridSize.x / 2);
 			float y = gridY * m_gridSize.y + (m_gridSize.y / 2);
-			entity->add<CTransform>(Vec2(x, y));
+			entity.add<CTransform>(Vec2(x, y));
 
 			float bbPosX, bbPosY, bbOffsetX, bbOffsetY, bbWidth, bbHeight;
 			bool blockMove, blockVision;
 			file >> bbPosX >> bbPosY >> bbOffsetX >> bbOffsetY
 				>> bbWidth >> bbHeight >> blockMove >> blockVision;
-			entity->add<CBoundingBox>(Vec2(bbPosX, bbPosY), Vec2(bbOffsetX, bbOffsetY),
+			entity.add<CBoundingBox>(Vec2(bbPosX, bbPosY), Vec2(bbOffsetX, bbOffsetY),
 				Vec2(bbWidth, bbHeight), blockMove, blockVision);
-			entity->add<CDraggable>().dragging = false;
+			entity.add<CDraggable>().dragging = false;
+			if (!m_tileGrid.set(gridX, gridY, entity.handle(), animation, blockMove, blockVision))
+			{
+				std::cerr << "Tile outside the map at " << gridX << " " << gridY << std::endl;
+				entity.destroy();
+				continue;
+			}
+			m_spatialHash.insert(entity.handle(), Vec2(x, y), m_gridSize / 2, true);
 		}
 		else if (str == "Decoration")
 		{
-			std::shared_ptr<Entity> entity;
-			entity = m_entityManager.addEntity(str);
+			auto& entity = m_entityManager.addEntity(str);
 			file >> str;
-			entity->add<CAnimation>(m_game->assets().getAnimation(str), true);
+			AnimationId animation = m_game->assets().animationId(str);
+			if (animation.isValid()) { entity.add<CAnimation>(animation, currentFrame(), true); }
+			else { std::cerr << "Unknown animation " << str << std::endl; }
 
 			int gridX, gridY;
 			file >> gridX >> gridY;
 			float x = gridX * m_gridSize.x + (m_gridSize.x / 2);
 			float y = gridY * m_gridSize.y + (m_gridSize.y / 2);
-			entity->add<CTransform>(Vec2(x, y));
-			entity->add<CDraggable>().dragging = false;
+			entity.add<CTransform>(Vec2(x, y));
+			entity.add<CDraggable>().dragging = false;
+			if (!m_tileGrid.set(gridX, gridY, entity.handle(), animation, false, false))
+			{
+				std::cerr << "Decoration outside the map at " << gridX << " " << gridY << std::endl;
+				entity.destroy();
+				continue;
+			}
+			m_spatialHash.insert(entity.handle(), Vec2(x, y), m_gridSize / 2, true);
 		}
 		else { std::cout << "Invalid entity type: " + str << " name:"; }
 	}
+	m_tileGrid.fitToContents();
 }
 
 Vec2 Scene_Level_Editor::windowToWorld(const Vec2& window) const
@@ -108,11 +132,11 @@ Vec2 Scene_Level_Editor::windowToWorld(const Vec2& window) const
 	return Vec2(window.x + wx, window.y + wy);
 }
 
-Vec2 Scene_Level_Editor::rotate(std::shared_ptr<Entity> e, float angle)
+Vec2 Scene_Level_Editor::rotate(Entity& e, float angle)
 {
 	float angleInRadians = angle * M_PI / 180;
-	auto& eTransform = e->get<CTransform>();
-	auto& bb = e->get<CBoundingBox>();
+	auto& eTransform = e.get<CTransform>();
+	auto& bb = e.get<CBoundingBox>();
 
 	// bounding box pos when the point of rotation is translated to the origin
 	float translatedX = bb.pos.x - eTransform.pos.x;
@@ -133,8 +157,14 @@ void Scene_Level_Editor::update()
 {
 	m_entityManager.update();
 
-	sDragAndDrop();
-	sGui();
+	{
+		PROFILE_SCOPE("DragAndDrop");
+		sDragAndDrop();
+	}
+	{
+		PROFILE_SCOPE("Gui");
+		sGui();
+	}
 }
 
 bool Scene_Level_Editor::saveToFile(const char* filename)
@@ -150,15 +180,17 @@ bool Scene_Level_Editor::saveToFile(const char* filename)
 
 	for (auto& e : m_entityManager.getEntities())
 	{
-		out << e->tag() << " " << e->get<CAnimation>().animation.getName() << " ";
-		auto& transform = e->get<CTransform>();
-		auto& boundingBox = e->get<CBoundingBox>();
+		// read through a const entity so components it doesn't have come back empty instead of being added
+		const Entity& entity = *e;
+		out << entity.tag() << " " << m_game->assets().getAnimation(entity.get<CAnimation>().id).getName() << " ";
+		auto& transform = entity.get<CTransform>();
+		auto& boundingBox = entity.get<CBoundingBox>();
 
 		int gridX = (int)transform.pos.x / m_gridSize.x;
 		int gridY = (int)transform.pos.y / m_gridSize.y;
 		out << gridX << " " << gridY << " ";
 
-		if (e->tag() != "Decoration")
+		if (entity.tag() != "Decoration")
 		{
 			out << boundingBox.pos.x << " " << boundingBox.pos.y << " "
 				<< boundingBox.offset.x << " " << boundingBox.offset.y << " "
@@ -178,124 +210,149 @@ void Scene_Level_Editor::onEnd()
 
 void Scene_Level_Editor::sDoAction(const Action& action)
 {
-	if (action.name() == "MOUSE_MOVE")
+	if (action.id() == ActionId::MouseMove)
 	{
 		m_mousePos = action.pos();
 	}
 
-	if (action.type() == "START")
-	{
-			 if (action.name() == "UP") { }
-		else if (action.name() == "DOWN") { }
-		else if (action.name() == "LEFT") { }
-		else if (action.name() == "RIGHT") { }
-		else if (action.name() == "ROTATE_CLOCKWISE") 
-		{ 
-			auto& transform = m_entityBeingDragged->get<CTransform>();
-			if (transform.angle >= 270) { transform.angle = 0; }
-			else						{ transform.angle += 90; }
-
-			m_entityBeingDragged->get<CBoundingBox>().pos = rotate(m_entityBeingDragged, 90);
-		}
-		else if (action.name() == "ROTATE_COUNTERCLOCKWISE")
-		{
-			auto& transform = m_entityBeingDragged->get<CTransform>();
-			if (transform.angle <= -270) { transform.angle = 0; }
-			else						 { transform.angle -= 90; }
+	if (action.type() != ActionType::Start) { return; }
 
-			m_entityBeingDragged->get<CBoundingBox>().pos = rotate(m_entityBeingDragged, -90);
-		}
-		else if (action.name() == "TOGGLE_TEXTURE") { m_drawTextures = !m_drawTextures; }
-		else if (action.name() == "TOGGLE_COLLISION") { m_drawCollision = !m_drawCollision; }
-		else if (action.name() == "TOGGLE_GRID") { m_drawGrid = !m_drawGrid; }
-		else if (action.name() == "QUIT") { onEnd(); }
-		else if (action.name() == "LEFT_CLICK")
-		{
-			m_mousePos = action.pos();
+	// resolves to nullptr if nothing is being dragged or the dragged entity was destroyed
+	Entity* dragged = m_entityManager.getEntity(m_entityBeingDragged);
 
-			// Prevent mouse clicks from registering under the ImGui window.
-			// This prevents an entity currently being dragged from being dropped under the ImGui window.
-			if (!ImGui::GetIO().WantCaptureMouse) 
-			{
-				Vec2 wMousePos = windowToWorld(m_mousePos);
-				if (m_entityBeingDragged != nullptr)
-				{
-					bool cellOccupied = false;
+	switch (action.id())
+	{
+	case ActionId::RotateClockwise:
+	{
+		if (dragged == nullptr) { break; }
 
-					// find the grid position the mouse click is in.
-					int gridX = (int)wMousePos.x / (int)m_gridSize.x;
-					int gridY = (int)wMousePos.y / (int)m_gridSize.y;
+		auto& transform = dragged->get<CTransform>();
+		if (transform.angle >= 270) { transform.angle = 0; }
+		else						{ transform.angle += 90; }
 
-					// calculate the top left coordinates of the cell
-					int topLeftX = (int)gridX * (int)m_gridSize.x;
-					int topLeftY = (int)gridY * (int)m_gridSize.y;
+		if (dragged->has<CBoundingBox>()) { dragged->get<CBoundingBox>().pos = rotate(*dragged, 90); }
+		break;
+	}
+	case ActionId::RotateCounterclockwise:
+	{
+		if (dragged == nullptr) { break; }
 
-					// calculate the origin on the the cell since an entity's position is represented by its origin
-					Vec2 gridOrigin(topLeftX + m_gridSize.x / 2, topLeftY + m_gridSize.y / 2);
-					for (auto& e : m_entityManager.getEntities())
-					{
-						if (gridOrigin == e->get<CTransform>().pos && m_entityBeingDragged != e)
-						{
-							cellOccupied = true;
-							break;
-						}
-					}
-					if (!cellOccupied)
-					{
-						auto& dragging = m_entityBeingDragged->get<CDraggable>().dragging;
-						dragging = !dragging;
+		auto& transform = dragged->get<CTransform>();
+		if (transform.angle <= -270) { transform.angle = 0; }
+		else						 { transform.angle -= 90; }
 
-						// "snap" the entity to the grid position
-						Vec2 offset = m_entityBeingDragged->get<CTransform>().pos - gridOrigin;
-						m_entityBeingDragged->get<CTransform>().pos = gridOrigin;
-						m_entityBeingDragged->get<CBoundingBox>().pos -= offset;
-						
-						// entity is no longer being dragged
-						m_entityBeingDragged = nullptr;
-					}
+		if (dragged->has<CBoundingBox>()) { dragged->get<CBoundingBox>().pos = rotate(*dragged, -90); }
+		break;
+	}
+	case ActionId::ToggleTexture:	{ m_drawTextures = !m_drawTextures; break; }
+	case ActionId::ToggleCollision: { m_drawCollision = !m_drawCollision; break; }
+	case ActionId::ToggleGrid:		{ m_drawGrid = !m_drawGrid; break; }
+	case ActionId::Quit:			{ onEnd(); break; }
+	case ActionId::LeftClick:
+	{
+		m_mousePos = action.pos();
+
+		// Prevent mouse clicks from registering under the ImGui window.
+		// This prevents an entity currently being dragged from being dropped under the ImGui window.
+		if (!ImGui::GetIO().WantCaptureMouse) 
+		{
+			Vec2 wMousePos = windowToWorld(m_mousePos);
+			if (dragged != nullptr)
+			{
+				// find the grid position the mouse click is in.
+				int gridX, gridY;
+				m_tileGrid.worldToCell(wMousePos, gridX, gridY);
+
+				// calculate the top left coordinates of the cell
+				int topLeftX = (int)gridX * (int)m_gridSize.x;
+				int topLeftY = (int)gridY * (int)m_gridSize.y;
+
+				// calculate the origin on the the cell since an entity's position is represented by its origin
+				Vec2 gridOrigin(topLeftX + m_gridSize.x / 2, topLeftY + m_gridSize.y / 2);
+
+				// The dragged entity was taken out of the tile grid when it was picked up. Cells left of or
+				// above the map can't hold it, so there it stays on the mouse.
+				const Entity& placed = *dragged;
+				auto& bb = placed.get<CBoundingBox>();
+				if (!m_tileGrid.occupied(gridX, gridY) &&
+					m_tileGrid.set(gridX, gridY, m_entityBeingDragged, placed.get<CAnimation>().id, bb.blockMove, bb.blockVision))
+				{
+					auto& dragging = dragged->get<CDraggable>().dragging;
+					dragging = !dragging;
+
+					// "snap" the entity to the grid position
+					Vec2 offset = dragged->get<CTransform>().pos - gridOrigin;
+					dragged->get<CTransform>().pos = gridOrigin;
+					if (dragged->has<CBoundingBox>()) { dragged->get<CBoundingBox>().pos -= offset; }
+					m_spatialHash.insert(m_entityBeingDragged, gridOrigin, m_gridSize / 2, true);
+					m_tileGrid.fitToContents();
+					
+					// entity is no longer being dragged
+					m_entityBeingDragged = EntityHandle();
 				}
-				else
+			}
+			else
+			{
+				// only the entities registered in the clicked cell can be under the mouse
+				Physics phy;
+				HandleVec underMouse(m_entityManager.frameArena());
+				m_spatialHash.queryPoint(wMousePos, underMouse);
+				for (auto handle : underMouse)
 				{
-					Physics phy;
-					for (auto& e : m_entityManager.getEntities())
+					Entity* e = m_entityManager.getEntity(handle);
+					if (e != nullptr && e->has<CDraggable>() && phy.IsInside(wMousePos, *e, m_game->assets().getAnimation(std::as_const(*e).get<CAnimation>().id)))
 					{
-						if (!e->has<CDraggable>()) { continue; }
-
-						if (phy.IsInside(wMousePos, e))
+						auto& dragging = e->get<CDraggable>().dragging;
+						dragging = !dragging;
+						if (dragging)
 						{
-							auto& dragging = e->get<CDraggable>().dragging;
-							dragging = !dragging;
-							if (dragging) {	m_entityBeingDragged = e; }
-							else { m_entityBeingDragged = nullptr; }
+							// the entity follows the mouse until it is dropped so take it out of the spatial hash and tile grid
+							m_entityBeingDragged = handle;
+							m_spatialHash.remove(handle);
+							int cellX, cellY;
+							m_tileGrid.worldToCell(e->get<CTransform>().pos, cellX, cellY);
+							m_tileGrid.clear(cellX, cellY, handle);
 						}
+						else { m_entityBeingDragged = EntityHandle(); }
 					}
 				}
 			}
 		}
-		else if (action.name() == "RIGHT_CLICK")
+		break;
+	}
+	case ActionId::RightClick:
+	{
+		if (dragged != nullptr)
 		{
-			if (m_entityBeingDragged != nullptr)
-			{
-				m_entityBeingDragged->destroy();
-				m_entityBeingDragged = nullptr;
-			}
+			destroyEntity(*dragged);
+			m_entityBeingDragged = EntityHandle();
 		}
+		break;
+	}
+	default: break;
 	}
 }
 
+void Scene_Level_Editor::destroyEntity(Entity& e)
+{
+	int cellX, cellY;
+	m_tileGrid.worldToCell(e.get<CTransform>().pos, cellX, cellY);
+	m_tileGrid.clear(cellX, cellY, e.handle());
+	m_spatialHash.remove(e.handle());
+	e.destroy();
+}
+
 void Scene_Level_Editor::sDragAndDrop()
 {
-	for (auto& e : m_entityManager.getEntities())
+	for (auto& e : m_entityManager.view<CTransform, CDraggable>())
 	{
-		if (e->has<CDraggable>() && e->get<CDraggable>().dragging)
+		if (e.get<CDraggable>().dragging)
 		{
-			auto& transform = e->get<CTransform>();
-			auto& bb = e->get<CBoundingBox>();
-
+			auto& transform = e.get<CTransform>();
 			Vec2 wPos = windowToWorld(m_mousePos);
 			Vec2 offset(wPos - transform.pos);
 			transform.pos = wPos;
-			bb.pos += offset;
+			if (e.has<CBoundingBox>()) { e.get<CBoundingBox>().pos += offset; }
 		}
 	}
 }
@@ -343,16 +400,18 @@ void Scene_Level_Editor::sGui()
 				ImGui::Dummy(ImVec2(0.0f, 45.0f));
 				ImGui::Dummy(ImVec2(10.0f, 0.0f));
 				ImGui::SameLine();
-				if (m_animationSelected.getName() != "none")
+				if (m_animationSelected.isValid())
 				{
-					if (ImGui::ImageButton("selectArea", m_animationSelected.getSprite(), sf::Vector2f(m_gridSize.x, m_gridSize.y)))
+					sf::Sprite selected;
+					m_game->assets().getAnimation(m_animationSelected).applyFrame(selected, 0);
+					if (ImGui::ImageButton("selectArea", selected, sf::Vector2f(m_gridSize.x, m_gridSize.y)))
 					{
-						if (m_entityBeingDragged == nullptr)
+						if (!m_entityManager.isValid(m_entityBeingDragged))
 						{
-							auto entity = m_entityManager.addEntity(m_entityTypes[m_animTypeComboSelectedIndex]);
-							entity->add<CAnimation>(m_animationSelected, true);
+							auto& entity = m_entityManager.addEntity(m_entityTypes[m_animTypeComboSelectedIndex]);
+							entity.add<CAnimation>(m_animationSelected, currentFrame(), true);
 							auto wPos = windowToWorld(m_mousePos);
-							entity->add<CTransform>(wPos);
+							entity.add<CTransform>(wPos);
 
 							// Decoration entity types won't have a bounding box
 							if (m_entityTypes[m_animTypeComboSelectedIndex] != "Decoration")
@@ -370,14 +429,14 @@ void Scene_Level_Editor::sGui()
 
 								// The offset of the bounding box's origin from the entity's origin is needed to be able to update the bounding boxes position.
 								Vec2 bbOffset(bbOrigin.x - wPos.x, bbOrigin.y - wPos.y);
-								entity->add<CBoundingBox>(bbOrigin, bbOffset, bbSize, m_blockMoveCheckbox, m_blockVisionCheckbox);
+								entity.add<CBoundingBox>(bbOrigin, bbOffset, bbSize, m_blockMoveCheckbox, m_blockVisionCheckbox);
 							}
 
-							entity->add<CDraggable>().dragging = true;
-							m_entityBeingDragged = entity;
+							entity.add<CDraggable>().dragging = true;
+							m_entityBeingDragged = entity.handle();
 
-							// Use an default constructed animation object to represent an unselected animation
-							m_animationSelected = Animation();
+							// an invalid id means no animation is selected
+							m_animationSelected = AnimationId();
 
 							// Set the slider variables back to a default grid size.
 							m_boundingBoxLeft = 0;
@@ -476,13 +535,15 @@ void Scene_Level_Editor::sGui()
 
 			int counterOfAnimations = 0;
 			ImVec2 windowSize = ImGui::GetWindowSize();
-			for (const auto& [name, anim] : m_game->assets().getAnimations())
+			for (uint32_t i = 0; i < m_game->assets().animationCount(); ++i)
 			{
 				counterOfAnimations++;
 				
-				if (ImGui::ImageButton(("id##" + std::to_string(counterOfAnimations)).c_str(), anim.getSprite(), sf::Vector2f(64, 64)))
+				sf::Sprite sprite;
+				if (!m_game->assets().getAnimation(AnimationId{ i }).applyFrame(sprite, 0)) { continue; }
+				if (ImGui::ImageButton(("id##" + std::to_string(counterOfAnimations)).c_str(), sprite, sf::Vector2f(64, 64)))
 				{
-					m_animationSelected = anim;
+					m_animationSelected = AnimationId{ i };
 				}
 				ImGuiStyle style;
 				int buttonsPerRow = (int)ImGui::GetWindowSize().x / (int)(ImGui::GetItemRectSize().x + (style.FramePadding.x * 2.0f));
@@ -504,90 +565,92 @@ void Scene_Level_Editor::sGui()
 				ImGui::Indent(20.0f);
 				if (ImGui::CollapsingHeader("tile"))
 				{
-					// check for the key named "Tile" is existing in map before querying the map
-					if (m_entityManager.getEntityMap().find("Tile") != m_entityManager.getEntityMap().end())
+					if (!m_entityManager.getEntities("Tile").empty())
 					{
 						ImGui::Indent(20.0f);
-						for (auto& e : m_entityManager.getEntityMap().at("Tile"))
+						for (auto& e : m_entityManager.getEntities("Tile"))
 						{
 							if (ImGui::Button(("D##" + std::to_string(e->id())).c_str()))
 							{
-								e->destroy();
+								destroyEntity(*e);
 							}
+							const Entity& entity = *e;
 							ImGui::SameLine();
 							ImGui::Text(std::to_string(e->id()).c_str());
 							ImGui::SameLine();
 							ImGui::Text(e->tag().c_str());
 							ImGui::SameLine();
-							ImGui::Text(e->get<CAnimation>().animation.getName().c_str());
+							ImGui::Text(m_game->assets().getAnimation(entity.get<CAnimation>().id).getName().c_str());
 							ImGui::SameLine();
-							ImGui::Text(("Pos: (" + std::to_string((int)e->get<CTransform>().pos.x) + "," +
-								std::to_string((int)e->get<CTransform>().pos.y) + ")").c_str());
+							ImGui::Text(("Pos: (" + std::to_string((int)entity.get<CTransform>().pos.x) + "," +
+								std::to_string((int)entity.get<CTransform>().pos.y) + ")").c_str());
 							ImGui::SameLine();
-							ImGui::Text(("BBpos: (" + std::to_string((int)e->get<CBoundingBox>().pos.x) + "," + std::to_string((int)e->get<CBoundingBox>().pos.y) + ")" +
-								" BBOffset: (" + std::to_string((int)e->get<CBoundingBox>().offset.x) + ", " + std::to_string((int)e->get<CBoundingBox>().offset.y) + ")").c_str());
+							ImGui::Text(("BBpos: (" + std::to_string((int)entity.get<CBoundingBox>().pos.x) + "," + std::to_string((int)entity.get<CBoundingBox>().pos.y) + ")" +
+								" BBOffset: (" + std::to_string((int)entity.get<CBoundingBox>().offset.x) + ", " + std::to_string((int)entity.get<CBoundingBox>().offset.y) + ")").c_str());
 						}
 						ImGui::Unindent(20.0f);
 					}
 				}
 				if (ImGui::CollapsingHeader("decoration"))
 				{
-					if (m_entityManager.getEntityMap().find("Decoration") != m_entityManager.getEntityMap().end())
+					if (!m_entityManager.getEntities("Decoration").empty())
 					{
 						ImGui::Indent(20.0f);
-						for (auto& e : m_entityManager.getEntityMap().at("Decoration"))
+						for (auto& e : m_entityManager.getEntities("Decoration"))
 						{
 							if (ImGui::Button(("D##" + std::to_string(e->id())).c_str()))
 							{
-								e->destroy();
+								destroyEntity(*e);
 							}
+							const Entity& entity = *e;
 							ImGui::SameLine();
 							ImGui::Text(std::to_string(e->id()).c_str());
 							ImGui::SameLine();
 							ImGui::Text(e->tag().c_str());
 							ImGui::SameLine();
-							ImGui::Text(e->get<CAnimation>().animation.getName().c_str());
+							ImGui::Text(m_game->assets().getAnimation(entity.get<CAnimation>().id).getName().c_str());
 							ImGui::SameLine();
-							ImGui::Text(("(" + std::to_string((int)e->get<CTransform>().pos.x) + "," +
-								std::to_string((int)e->get<CTransform>().pos.y) + ")").c_str());
+							ImGui::Text(("(" + std::to_string((int)entity.get<CTransform>().pos.x) + "," +
+								std::to_string((int)entity.get<CTransform>().pos.y) + ")").c_str());
 						}
 						ImGui::Unindent(20.0f);
 					}
 				}
 				if (ImGui::CollapsingHeader("enemies"))
 				{
-					if (m_entityManager.getEntityMap().find("Enemies") != m_entityManager.getEntityMap().end())
+					if (!m_entityManager.getEntities("Enemies").empty())
 					{
 						ImGui::Indent(20.0f);
-						for (auto& e : m_entityManager.getEntityMap().at("Enemies"))
+						for (auto& e : m_entityManager.getEntities("Enemies"))
 						{
 							if (ImGui::Button(("D##" + std::to_string(e->id())).c_str()))
 							{
-								e->destroy();
+								destroyEntity(*e);
 							}
+							const Entity& entity = *e;
 							ImGui::SameLine();
 							ImGui::Text(std::to_string(e->id()).c_str());
 							ImGui::SameLine();
 							ImGui::Text(e->tag().c_str());
 							ImGui::SameLine();
-							ImGui::Text(e->get<CAnimation>().animation.getName().c_str());
+							ImGui::Text(m_game->assets().getAnimation(entity.get<CAnimation>().id).getName().c_str());
 							ImGui::SameLine();
-							ImGui::Text(("(" + std::to_string((int)e->get<CTransform>().pos.x) + "," +
-								std::to_string((int)e->get<CTransform>().pos.y) + ")").c_str());
+							ImGui::Text(("(" + std::to_string((int)entity.get<CTransform>().pos.x) + "," +
+								std::to_string((int)entity.get<CTransform>().pos.y) + ")").c_str());
 						}
 						ImGui::Unindent(20.0f);
 					}
 				}
 				if (ImGui::CollapsingHeader("player"))
 				{
-					if (m_entityManager.getEntityMap().find("Player") != m_entityManager.getEntityMap().end())
+					if (!m_entityManager.getEntities("Player").empty())
 					{
 						ImGui::Indent(20.0f);
-						for (auto& e : m_entityManager.getEntityMap().at("Player"))
+						for (auto& e : m_entityManager.getEntities("Player"))
 						{
 							if (ImGui::Button(("D##" + std::to_string(e->id())).c_str()))
 							{
-								e->destroy();
+								destroyEntity(*e);
 							}
 							ImGui::SameLine();
 							ImGui::Text(std::to_string(e->id()).c_str());
@@ -607,20 +670,35 @@ void Scene_Level_Editor::sGui()
 				{
 					if (ImGui::Button(("D##" + std::to_string(e->id())).c_str()))
 					{
-						e->destroy();
+						destroyEntity(*e);
 					}
+					const Entity& entity = *e;
 					ImGui::SameLine();
 					ImGui::Text(std::to_string(e->id()).c_str());
 					ImGui::SameLine();
 					ImGui::Text(e->tag().c_str());
 					ImGui::SameLine();
-					ImGui::Text(e->get<CAnimation>().animation.getName().c_str());
+					ImGui::Text(m_game->assets().getAnimation(entity.get<CAnimation>().id).getName().c_str());
 					ImGui::SameLine();
-					ImGui::Text(("(" + std::to_string((int)e->get<CTransform>().pos.x) + "," +
-						std::to_string((int)e->get<CTransform>().pos.y) + ")").c_str());
+					ImGui::Text(("(" + std::to_string((int)entity.get<CTransform>().pos.x) + "," +
+						std::to_string((int)entity.get<CTransform>().pos.y) + ")").c_str());
 				}
 				ImGui::Unindent(20.0f);
 			}
+			if (ImGui::CollapsingHeader("Memory"))
+			{
+				EntityMemoryStats stats = m_entityManager.memoryStats();
+				ImGui::Indent(20.0f);
+				ImGui::Text("Live entities: %zu (peak %zu)", stats.liveEntities, stats.peakEntities);
+				ImGui::Text("Entity slots: %zu (%zu free, %zu reuses)", stats.slots, stats.freeSlots, stats.slotReuses);
+				ImGui::Text("Entity bytes: %zu", stats.entityBytes);
+				ImGui::Text("Component bytes: %zu", stats.componentBytes);
+				ImGui::Text("Frame arena: %zu / %zu bytes (peak %zu)", stats.arenaBytes, stats.arenaCapacity, stats.arenaPeakBytes);
+				ImGui::Text("Tile grid: %d x %d cells, %zu bytes", m_tileGrid.width(), m_tileGrid.height(), m_tileGrid.memoryUsage());
+				ImGui::Text("Draw calls: %zu (%zu batches)", m_spriteBatch.drawCalls(), m_spriteBatch.batchCount());
+				ImGui::Text("Sprites: %zu, %zu quads rebuilt", m_spriteBatch.spritesAdded(), m_spriteBatch.quadsRebuilt());
+				ImGui::Unindent(20.0f);
+			}
 			ImGui::EndTabItem();
 		}
 		ImGui::EndTabBar();
@@ -632,52 +710,50 @@ void Scene_Level_Editor::sRender()
 {
 	m_game->window().clear(sf::Color::Black);
 
+	// tiles under decorations under everything else, the same layers as the home map
+	m_spriteBatch.begin();
+
 	if (m_drawTextures)
 	{
-		for (auto& e : m_entityManager.getEntities())
+		// skip over the entity being dragged as we want that entity to be drawn last and not drawn twice
+		collectVisibleSprites(m_entityBeingDragged);
+		sf::Sprite sprite;
+		for (const VisibleSprite& visible : m_visibleSprites)
 		{
-			// skip over the entity being dragged as we want that entity to be drawn last and not drawn twice
-			if (e == m_entityBeingDragged) { continue; }
-
-			auto& transform = e->get<CTransform>();
-			sf::Color c = sf::Color::White;
-			if (e->has<CAnimation>())
-			{
-				auto& animation = e->get<CAnimation>().animation;
-				animation.getSprite().setRotation(transform.angle);
-				animation.getSprite().setPosition(transform.pos.x, transform.pos.y);
-				animation.getSprite().setScale(transform.scale.x, transform.scale.y);
-				animation.getSprite().setColor(c);
-				m_game->window().draw(animation.getSprite());
-			}
+			Entity& e = *visible.entity;
+			auto& transform = e.get<CTransform>();
+			visible.clip->applyFrame(sprite, visible.frame);
+
+			sprite.setRotation(transform.angle);
+			sprite.setPosition(transform.pos.x, transform.pos.y);
+			sprite.setScale(transform.scale.x, transform.scale.y);
+			sprite.setColor(sf::Color::White);
+			int layer = e.tagId() == m_tileTag ? 0 : (e.tagId() == m_decorationTag ? 1 : 2);
+			m_spriteBatch.add(e.handle(), layer, sprite);
 		}
 	}
 
 	if (m_drawCollision)
 	{
-		for (auto& e : m_entityManager.getEntities())
+		for (auto& e : m_entityManager.view<CTransform, CBoundingBox>())
 		{
-			if (e->has<CBoundingBox>())
-			{
-				auto& box = e->get<CBoundingBox>();
-				auto& transform = e->get<CTransform>();
-				sf::RectangleShape rect;
-				rect.setSize(sf::Vector2f(box.size.x - 1, box.size.y - 1));
-				rect.setOrigin(sf::Vector2f(box.halfSize.x, box.halfSize.y));
-				rect.setPosition(box.pos.x, box.pos.y);
-				rect.setRotation(transform.angle);
-				rect.setFillColor(sf::Color(255, 0, 0, 0));
-
-				if (box.blockMove && box.blockVision) { rect.setOutlineColor(sf::Color::Black); }
-				if (box.blockMove && !box.blockVision) { rect.setOutlineColor(sf::Color::Blue); }
-				if (!box.blockMove && box.blockVision) { rect.setOutlineColor(sf::Color::Red); }
-				if (!box.blockMove && !box.blockVision) { rect.setOutlineColor(sf::Color::White); }
-				rect.setOutlineThickness(1);
-				m_game->window().draw(rect);
-			}
+			auto& box = e.get<CBoundingBox>();
+			auto& transform = e.get<CTransform>();
+			sf::Transform rotation;
+			rotation.translate(box.pos.x, box.pos.y).rotate(transform.angle);
+			sf::FloatRect rect(-box.halfSize.x, -box.halfSize.y, box.size.x - 1, box.size.y - 1);
+
+			sf::Color color = sf::Color::White;
+			if (box.blockMove && box.blockVision) { color = sf::Color::Black; }
+			if (box.blockMove && !box.blockVision) { color = sf::Color::Blue; }
+			if (!box.blockMove && box.blockVision) { color = sf::Color::Red; }
+			m_spriteBatch.addRect(rect, color, 1, rotation);
 		}
 	}
 
+	m_spriteBatch.end();
+	m_spriteBatch.draw(m_game->window());
+
 	if (m_drawGrid)
 	{
 		float leftX = m_game->window().getView().getCenter().x - (float)width() / 2;
@@ -707,7 +783,7 @@ void Scene_Level_Editor::sRender()
 	ImGui::SFML::Render(m_game->window());
 
 	// draw visual representation of a bounding box that is adjustable by the sliders
-	if (m_animationSelected.getName() != "none")
+	if (m_animationSelected.isValid())
 	{
 		sf::RectangleShape rectangle;
 		rectangle.setPosition(m_selectionAreaBoundingBoxPos.x + m_boundingBoxLeft, m_selectionAreaBoundingBoxPos.y + m_boundingBoxTop);
@@ -719,18 +795,21 @@ void Scene_Level_Editor::sRender()
 	}
 
 	// draw the dragging entity after the rendering of ImGui so the dragged entity is drawn on top
-	if (m_entityBeingDragged != nullptr)
+	if (Entity* dragged = m_entityManager.getEntity(m_entityBeingDragged))
 	{
-		auto& transform = m_entityBeingDragged->get<CTransform>();
-		sf::Color c = sf::Color::White;
-		if (m_entityBeingDragged->has<CAnimation>())
+		auto& transform = dragged->get<CTransform>();
+		sf::Sprite sprite;
+		if (dragged->has<CAnimation>())
 		{
-			auto& animation = m_entityBeingDragged->get<CAnimation>().animation;
-			animation.getSprite().setRotation(transform.angle);
-			animation.getSprite().setPosition(transform.pos.x, transform.pos.y);
-			animation.getSprite().setScale(transform.scale.x, transform.scale.y);
-			animation.getSprite().setColor(c);
-			m_game->window().draw(animation.getSprite());
+			auto& animation = dragged->get<CAnimation>();
+			const Animation& clip = m_game->assets().getAnimation(animation.id);
+			if (clip.applyFrame(sprite, clip.frameAt(currentFrame() - animation.startFrame, animation.repeat)))
+			{
+				sprite.setRotation(transform.angle);
+				sprite.setPosition(transform.pos.x, transform.pos.y);
+				sprite.setScale(transform.scale.x, transform.scale.y);
+				m_game->window().draw(sprite);
+			}
 		}
 	}
 }
\ No newline at end of file
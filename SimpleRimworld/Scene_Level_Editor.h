@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Scene.h"
+#include "SpatialHash.h"
+#include "TileGrid.h"
+#include "SpriteBatch.h"
 
 class Scene_Level_Editor : public Scene
 {
@@ -12,8 +15,13 @@ class Scene_Level_Editor : public Scene
 	sf::Text					m_gridText;
 	Vec2						m_mousePos;
 	std::vector<std::string>	m_entityTypes;
-	Animation					m_animationSelected = Animation();
-	std::shared_ptr<Entity>		m_entityBeingDragged = nullptr;
+	AnimationId					m_animationSelected;	// invalid when nothing is selected
+	EntityHandle				m_entityBeingDragged;
+	SpatialHash					m_spatialHash = SpatialHash(m_gridSize);	// placed entities, the dragged entity is kept out of it
+	TileGrid					m_tileGrid = TileGrid(0, 0, m_gridSize);	// same as above, one entity per grid cell
+	TagId						m_tileTag = 0;			// resolved when the level loads so drawing doesn't look names up
+	TagId						m_decorationTag = 0;
+	SpriteBatch					m_spriteBatch;
 
 	// ImGui member variables
 	const char* m_animTypeComboPreviewValue = nullptr;
@@ -32,7 +40,8 @@ protected:
 	void init();
 	void loadLevel(const std::string& filename);
 	Vec2 windowToWorld(const Vec2& window) const;
-	Vec2 rotate(std::shared_ptr<Entity> e, float angle);
+	Vec2 rotate(Entity& e, float angle);
+	void destroyEntity(Entity& e);
 	void update();
 	bool saveToFile(const char* filename);
 	void onEnd();
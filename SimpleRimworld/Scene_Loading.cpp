@@ -0,0 +1,52 @@
+#include "Scene_Loading.h"
+#include "Scene_Menu.h"
+#include "GameEngine.h"
+
+Scene_Loading::Scene_Loading(GameEngine* gameEngine)
+	: Scene(gameEngine)
+{
+	init();
+}
+
+void Scene_Loading::init()
+{
+	registerAction(sf::Keyboard::Escape, ActionId::Quit);
+}
+
+void Scene_Loading::update()
+{
+	if (m_game->assets().updateLoading(m_uploadBudget))
+	{
+		m_game->changeScene("MENU", std::make_shared<Scene_Menu>(m_game), true);
+	}
+}
+
+void Scene_Loading::onEnd()
+{
+	m_game->quit();
+}
+
+void Scene_Loading::sDoAction(const Action& action)
+{
+	if (action.type() == ActionType::Start && action.id() == ActionId::Quit) { onEnd(); }
+}
+
+void Scene_Loading::sRender()
+{
+	auto& window = m_game->window();
+	window.clear(sf::Color(20, 22, 26));
+
+	// no font is loaded yet, so the progress is only a bar
+	sf::Vector2f size(width() / 2.0f, 24.0f);
+	sf::RectangleShape bar(size);
+	bar.setPosition(width() / 2.0f - size.x / 2.0f, height() / 2.0f - size.y / 2.0f);
+	bar.setFillColor(sf::Color::Transparent);
+	bar.setOutlineColor(sf::Color(158, 97, 22));
+	bar.setOutlineThickness(2);
+	window.draw(bar);
+
+	bar.setSize(sf::Vector2f(size.x * m_game->assets().loadingProgress(), size.y));
+	bar.setFillColor(sf::Color(158, 97, 22));
+	bar.setOutlineThickness(0);
+	window.draw(bar);
+}
\ No newline at end of file
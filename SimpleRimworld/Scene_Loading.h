@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Scene.h"
+
+// Shown while the assets load. Each frame it finishes whatever the loader threads have decoded, for at
+// most m_uploadBudget so the window keeps drawing, and moves on to the menu once everything is loaded.
+class Scene_Loading : public Scene
+{
+protected:
+
+	sf::Time m_uploadBudget = sf::milliseconds(8);
+
+	void init();
+	void update();
+	void onEnd();
+	void sDoAction(const Action& action);
+
+public:
+
+	Scene_Loading() {}
+	Scene_Loading(GameEngine* gameEngine);
+
+	void sRender();
+};
\ No newline at end of file
@@ -22,12 +22,12 @@ void Scene_Menu::init()
 	m_levelPaths.push_back("map_home.txt");
 	m_levelPaths.push_back("level_editor.txt");
 
-	m_menuText.setFont(m_game->assets().getFont("Tech"));
+	m_menuText.setFont(m_game->assets().getFont(m_game->assets().fontId("Tech")));
 
-	registerAction(sf::Keyboard::W, "UP");
-	registerAction(sf::Keyboard::S, "DOWN");
-	registerAction(sf::Keyboard::D, "PLAY");
-	registerAction(sf::Keyboard::Escape, "QUIT");
+	registerAction(sf::Keyboard::W, ActionId::Up);
+	registerAction(sf::Keyboard::S, ActionId::Down);
+	registerAction(sf::Keyboard::D, ActionId::Play);
+	registerAction(sf::Keyboard::Escape, ActionId::Quit);
 }
 
 void Scene_Menu::update()
@@ -42,35 +42,42 @@ void Scene_Menu::onEnd()
 
 void Scene_Menu::sDoAction(const Action& action)
 {
-	if (action.type() == "START")
+	if (action.type() != ActionType::Start) { return; }
+
+	switch (action.id())
 	{
-		if (action.name() == "PLAY")
-		{
-			if (m_menuStrings[m_selectedMenuIndex] == "Start")
-			{
-				m_game->changeScene("PLAY", std::make_shared<Scene_Home_Map>(m_game, m_levelPaths[m_selectedMenuIndex]));
-			}
-			else if (m_menuStrings[m_selectedMenuIndex] == "Level Editor")
-			{
-				m_game->changeScene("EDITOR", std::make_shared<Scene_Level_Editor>(m_game, m_levelPaths[m_selectedMenuIndex]));
-			}
-			else if (m_menuStrings[m_selectedMenuIndex] == "Options")
-			{
-				m_game->changeScene("OPTIONS", std::make_shared<Scene_Options_Menu>(m_game, m_levelPaths[m_selectedMenuIndex]));
-			}
-		}
-		else if (action.name() == "UP")
+	case ActionId::Play:
+	{
+		if (m_menuStrings[m_selectedMenuIndex] == "Start")
 		{
-			m_selectedMenuIndex = (m_selectedMenuIndex > 0) ? --m_selectedMenuIndex : m_menuStrings.size() - 1;
+			m_game->changeScene("PLAY", std::make_shared<Scene_Home_Map>(m_game, m_levelPaths[m_selectedMenuIndex]));
 		}
-		else if (action.name() == "DOWN")
+		else if (m_menuStrings[m_selectedMenuIndex] == "Level Editor")
 		{
-			m_selectedMenuIndex = (m_selectedMenuIndex + 1) % m_menuStrings.size();
+			m_game->changeScene("EDITOR", std::make_shared<Scene_Level_Editor>(m_game, m_levelPaths[m_selectedMenuIndex]));
 		}
-		else if (action.name() == "QUIT")
+		else if (m_menuStrings[m_selectedMenuIndex] == "Options")
 		{
-			onEnd();
+			m_game->changeScene("OPTIONS", std::make_shared<Scene_Options_Menu>(m_game, m_levelPaths[m_selectedMenuIndex]));
 		}
+		break;
+	}
+	case ActionId::Up:
+	{
+		m_selectedMenuIndex = (m_selectedMenuIndex > 0) ? --m_selectedMenuIndex : m_menuStrings.size() - 1;
+		break;
+	}
+	case ActionId::Down:
+	{
+		m_selectedMenuIndex = (m_selectedMenuIndex + 1) % m_menuStrings.size();
+		break;
+	}
+	case ActionId::Quit:
+	{
+		onEnd();
+		break;
+	}
+	default: break;
 	}
 }
 
@@ -146,7 +153,7 @@ void Scene_Menu::sRender()
 	}
 
 	// Setup navigation helper text
-	sf::Font font = m_game->assets().getFont("Tech");
+	const sf::Font& font = *m_menuText.getFont();
 	sf::Text upText("UP: W", font, 25);
 	sf::Text downText("DOWN: S", font, 25);
 	sf::Text playText("PLAY: D", font, 25);
@@ -0,0 +1,289 @@
+#include "SpatialHash.h"
+
+#include <cmath>
+
+SpatialHash::SpatialHash()
+{
+
+}
+
+SpatialHash::SpatialHash(const Vec2& cellSize)
+	: m_cellSize(cellSize)
+{
+
+}
+
+uint64_t SpatialHash::cellKey(int x, int y)
+{
+	return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+size_t SpatialHash::slotFor(uint64_t key) const
+{
+	// Fibonacci hashing spreads neighbouring cells across the table, then probe until the key or an empty slot
+	size_t mask = m_slotKeys.size() - 1;
+	size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+	while (m_slotCells[slot] != emptySlot && m_slotKeys[slot] != key)
+	{
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+void SpatialHash::grow()
+{
+	std::vector<uint64_t> oldKeys;
+	std::vector<uint32_t> oldCells;
+	oldKeys.swap(m_slotKeys);
+	oldCells.swap(m_slotCells);
+
+	size_t capacity = oldKeys.empty() ? 1024 : oldKeys.size() * 2;
+	m_slotKeys.assign(capacity, 0);
+	m_slotCells.assign(capacity, emptySlot);
+
+	for (size_t i = 0; i < oldKeys.size(); ++i)
+	{
+		if (oldCells[i] == emptySlot) { continue; }
+		size_t slot = slotFor(oldKeys[i]);
+		m_slotKeys[slot] = oldKeys[i];
+		m_slotCells[slot] = oldCells[i];
+	}
+}
+
+const std::vector<SpatialHash::CellEntry>* SpatialHash::findCell(int x, int y) const
+{
+	if (m_slotKeys.empty()) { return nullptr; }
+
+	size_t slot = slotFor(cellKey(x, y));
+	return m_slotCells[slot] == emptySlot ? nullptr : &m_cells[m_slotCells[slot]];
+}
+
+std::vector<SpatialHash::CellEntry>* SpatialHash::findCell(int x, int y)
+{
+	return const_cast<std::vector<CellEntry>*>(static_cast<const SpatialHash*>(this)->findCell(x, y));
+}
+
+std::vector<SpatialHash::CellEntry>& SpatialHash::getCell(int x, int y)
+{
+	// keep the table at most half full so probe runs stay short
+	if ((m_cells.size() + 1) * 2 > m_slotKeys.size()) { grow(); }
+
+	uint64_t key = cellKey(x, y);
+	size_t slot = slotFor(key);
+	if (m_slotCells[slot] == emptySlot)
+	{
+		m_slotKeys[slot] = key;
+		m_slotCells[slot] = (uint32_t)m_cells.size();
+		m_cells.emplace_back();
+	}
+	return m_cells[m_slotCells[slot]];
+}
+
+void SpatialHash::cellRange(const Vec2& min, const Vec2& max, int& minX, int& minY, int& maxX, int& maxY) const
+{
+	// Cells are half open so a 64x64 box sitting exactly on the grid only covers its own cell
+	// instead of also touching the cells to its right and below.
+	minX = (int)std::floor(min.x / m_cellSize.x);
+	minY = (int)std::floor(min.y / m_cellSize.y);
+	maxX = (int)std::ceil(max.x / m_cellSize.x) - 1;
+	maxY = (int)std::ceil(max.y / m_cellSize.y) - 1;
+	if (maxX < minX) { maxX = minX; }
+	if (maxY < minY) { maxY = minY; }
+}
+
+void SpatialHash::addToCells(uint32_t index)
+{
+	const Entry& entry = m_entries[index];
+	CellEntry cellEntry;
+	cellEntry.handle = entry.handle;
+	cellEntry.minX = entry.minX;
+	cellEntry.minY = entry.minY;
+	cellEntry.isStatic = entry.isStatic;
+
+	for (int x = entry.minX; x <= entry.maxX; ++x)
+	{
+		for (int y = entry.minY; y <= entry.maxY; ++y)
+		{
+			getCell(x, y).push_back(cellEntry);
+		}
+	}
+}
+
+void SpatialHash::removeFromCells(uint32_t index)
+{
+	const Entry& entry = m_entries[index];
+	for (int x = entry.minX; x <= entry.maxX; ++x)
+	{
+		for (int y = entry.minY; y <= entry.maxY; ++y)
+		{
+			// Empty cells are left in the table so entities moving back and forth across a cell border
+			// don't allocate and free the cell's vector every time.
+			std::vector<CellEntry>* cell = findCell(x, y);
+			if (cell == nullptr) { continue; }
+
+			for (size_t i = 0; i < cell->size(); ++i)
+			{
+				if ((*cell)[i].handle.index == index)
+				{
+					(*cell)[i] = cell->back();
+					cell->pop_back();
+					break;
+				}
+			}
+		}
+	}
+}
+
+void SpatialHash::insert(EntityHandle handle, const Vec2& center, const Vec2& halfSize, bool isStatic)
+{
+	if (handle.index >= m_entries.size()) { m_entries.resize(handle.index + 1); }
+	if (m_entries[handle.index].inserted) { remove(m_entries[handle.index].handle); }
+
+	Entry& entry = m_entries[handle.index];
+	entry.handle = handle;
+	entry.inserted = true;
+	entry.isStatic = isStatic;
+	cellRange(center - halfSize, center + halfSize, entry.minX, entry.minY, entry.maxX, entry.maxY);
+
+	if (!isStatic)
+	{
+		entry.dynamicIndex = m_dynamic.size();
+		m_dynamic.push_back(handle.index);
+	}
+
+	addToCells(handle.index);
+	++m_count;
+}
+
+void SpatialHash::update(EntityHandle handle, const Vec2& center, const Vec2& halfSize)
+{
+	if (!contains(handle)) { return; }
+
+	Entry& entry = m_entries[handle.index];
+	int minX, minY, maxX, maxY;
+	cellRange(center - halfSize, center + halfSize, minX, minY, maxX, maxY);
+
+	// most moves stay within the same cells so there is nothing to do
+	if (minX == entry.minX && minY == entry.minY && maxX == entry.maxX && maxY == entry.maxY) { return; }
+
+	removeFromCells(handle.index);
+	entry.minX = minX;
+	entry.minY = minY;
+	entry.maxX = maxX;
+	entry.maxY = maxY;
+	addToCells(handle.index);
+}
+
+void SpatialHash::remove(EntityHandle handle)
+{
+	if (!contains(handle)) { return; }
+
+	removeFromCells(handle.index);
+
+	Entry& entry = m_entries[handle.index];
+	if (!entry.isStatic)
+	{
+		uint32_t last = m_dynamic.back();
+		m_dynamic[entry.dynamicIndex] = last;
+		m_entries[last].dynamicIndex = entry.dynamicIndex;
+		m_dynamic.pop_back();
+	}
+	entry = Entry();
+	--m_count;
+}
+
+void SpatialHash::clear()
+{
+	m_slotKeys.clear();
+	m_slotCells.clear();
+	m_cells.clear();
+	m_entries.clear();
+	m_dynamic.clear();
+	m_count = 0;
+}
+
+bool SpatialHash::contains(EntityHandle handle) const
+{
+	return handle.index < m_entries.size() && m_entries[handle.index].inserted && m_entries[handle.index].handle == handle;
+}
+
+void SpatialHash::queryRegion(const Vec2& min, const Vec2& max, HandleVec& out) const
+{
+	int minX, minY, maxX, maxY;
+	cellRange(min, max, minX, minY, maxX, maxY);
+
+	for (int x = minX; x <= maxX; ++x)
+	{
+		for (int y = minY; y <= maxY; ++y)
+		{
+			const std::vector<CellEntry>* cell = findCell(x, y);
+			if (cell == nullptr) { continue; }
+
+			for (const CellEntry& entry : *cell)
+			{
+				// An entity covering several cells of the region is only reported from the first cell
+				// both ranges share, which avoids needing a visited set.
+				int firstX = entry.minX > minX ? entry.minX : minX;
+				int firstY = entry.minY > minY ? entry.minY : minY;
+				if (x == firstX && y == firstY) { out.push_back(entry.handle); }
+			}
+		}
+	}
+}
+
+void SpatialHash::queryPoint(const Vec2& point, HandleVec& out) const
+{
+	int x = (int)std::floor(point.x / m_cellSize.x);
+	int y = (int)std::floor(point.y / m_cellSize.y);
+
+	const std::vector<CellEntry>* cell = findCell(x, y);
+	if (cell == nullptr) { return; }
+
+	for (const CellEntry& entry : *cell)
+	{
+		out.push_back(entry.handle);
+	}
+}
+
+void SpatialHash::queryPairs(HandlePairVec& out) const
+{
+	for (uint32_t index : m_dynamic)
+	{
+		const Entry& a = m_entries[index];
+		for (int x = a.minX; x <= a.maxX; ++x)
+		{
+			for (int y = a.minY; y <= a.maxY; ++y)
+			{
+				const std::vector<CellEntry>* cell = findCell(x, y);
+				if (cell == nullptr) { continue; }
+
+				for (const CellEntry& b : *cell)
+				{
+					// a pair of dynamic entities would be found from both sides so keep only one ordering
+					uint32_t other = b.handle.index;
+					if (other == index || (!b.isStatic && other < index)) { continue; }
+
+					// only report the pair from the first cell the two boxes share
+					int firstX = a.minX > b.minX ? a.minX : b.minX;
+					int firstY = a.minY > b.minY ? a.minY : b.minY;
+					if (x == firstX && y == firstY) { out.push_back({ a.handle, b.handle }); }
+				}
+			}
+		}
+	}
+}
+
+const Vec2& SpatialHash::cellSize() const
+{
+	return m_cellSize;
+}
+
+size_t SpatialHash::cellCount() const
+{
+	return m_cells.size();
+}
+
+size_t SpatialHash::size() const
+{
+	return m_count;
+}
\ No newline at end of file
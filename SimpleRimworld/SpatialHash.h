@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Entity.h"
+#include "FrameArena.h"
+#include "Vec2.h"
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+typedef ArenaVector<EntityHandle>                          HandleVec;  // region and point results are frame scratch
+typedef std::vector<std::pair<EntityHandle, EntityHandle>> HandlePairVec;
+
+// A uniform grid of cells stored in a hash table so only occupied cells cost memory. Every entity is
+// registered with the axis aligned box it covers and is listed in each cell the box touches. Moving an
+// entity only touches the hash map when it crosses into a different set of cells.
+//
+// The hash doesn't watch CTransform, whatever moves a registered entity has to call update() itself. The
+// level editor is the only user so far: its placed entities never move, and one being dragged is removed
+// from the hash and inserted again where it is dropped.
+//
+// Entities are marked static or dynamic when inserted. Pair queries only start from dynamic entities,
+// so a map full of tiles that never move costs nothing until something walks next to them.
+class SpatialHash
+{
+	struct Entry
+	{
+		EntityHandle handle;
+		int          minX = 0, minY = 0, maxX = 0, maxY = 0;  // inclusive range of cells covered
+		size_t       dynamicIndex = 0;                        // position in m_dynamic when not static
+		bool         inserted = false;
+		bool         isStatic = true;
+	};
+
+	// What a cell stores about each entity in it. The pair and region queries only need these fields,
+	// so keeping a copy in the cell saves a random access into m_entries for every neighbour visited.
+	struct CellEntry
+	{
+		EntityHandle handle;
+		int          minX = 0, minY = 0;
+		bool         isStatic = true;
+	};
+
+	static constexpr uint32_t emptySlot = UINT32_MAX;
+
+	// The cell lookup is an open addressing table with linear probing. std::unordered_map allocates a
+	// node per cell and chases a pointer on every lookup, which was most of the cost of a pair query.
+	// Cells are never erased, so a slot only goes from empty to used and the probing needs no tombstones.
+	Vec2                                m_cellSize = { 64, 64 };
+	std::vector<uint64_t>               m_slotKeys;   // cell key stored in each table slot
+	std::vector<uint32_t>               m_slotCells;  // index into m_cells, emptySlot when the slot is unused
+	std::vector<std::vector<CellEntry>> m_cells;      // the entities in each occupied cell
+	std::vector<Entry>                  m_entries;    // indexed by EntityHandle::index
+	std::vector<uint32_t>               m_dynamic;    // indices of every dynamic entity
+	size_t                              m_count = 0;
+
+	static uint64_t cellKey(int x, int y);
+	size_t slotFor(uint64_t key) const;
+	void grow();
+	const std::vector<CellEntry>* findCell(int x, int y) const;
+	std::vector<CellEntry>* findCell(int x, int y);
+	std::vector<CellEntry>& getCell(int x, int y);
+	void cellRange(const Vec2& min, const Vec2& max, int& minX, int& minY, int& maxX, int& maxY) const;
+	void addToCells(uint32_t index);
+	void removeFromCells(uint32_t index);
+
+public:
+
+	SpatialHash();
+	SpatialHash(const Vec2& cellSize);
+
+	void insert(EntityHandle handle, const Vec2& center, const Vec2& halfSize, bool isStatic);
+	void update(EntityHandle handle, const Vec2& center, const Vec2& halfSize);
+	void remove(EntityHandle handle);
+	void clear();
+
+	bool contains(EntityHandle handle) const;
+
+	// Every entity registered in a cell the region touches, each reported once. Results are appended to
+	// out. This is a broad phase: the boxes are only known to the cell, so test the results yourself.
+	void queryRegion(const Vec2& min, const Vec2& max, HandleVec& out) const;
+
+	// Every entity registered in the cell holding the point, which may not contain the point itself.
+	void queryPoint(const Vec2& point, HandleVec& out) const;
+
+	// Candidate collision pairs: every dynamic entity paired with each entity it shares a cell with.
+	// Each pair is reported once and static-static pairs are never reported. This is only a broad
+	// phase so the boxes of a pair may still not overlap.
+	void queryPairs(HandlePairVec& out) const;
+
+	const Vec2& cellSize() const;
+	size_t cellCount() const;
+	size_t size() const;
+};
\ No newline at end of file
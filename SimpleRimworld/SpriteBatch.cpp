@@ -0,0 +1,253 @@
+#include "SpriteBatch.h"
+
+#include <cmath>
+#include <algorithm>
+
+bool SpriteBatch::SpriteKey::operator == (const SpriteKey& rhs) const
+{
+	return texture == rhs.texture && rect == rhs.rect && position == rhs.position && origin == rhs.origin &&
+		scale == rhs.scale && rotation == rhs.rotation && color == rhs.color;
+}
+
+SpriteBatch::SpriteBatch()
+{
+
+}
+
+void SpriteBatch::markDirty(Batch& batch, size_t quad)
+{
+	if (batch.dirtyBegin == batch.dirtyEnd)
+	{
+		batch.dirtyBegin = quad;
+		batch.dirtyEnd = quad + 1;
+		return;
+	}
+	batch.dirtyBegin = std::min(batch.dirtyBegin, quad);
+	batch.dirtyEnd = std::max(batch.dirtyEnd, quad + 1);
+}
+
+uint32_t SpriteBatch::batchFor(const sf::Texture* texture, int layer)
+{
+	for (uint32_t i = 0; i < m_batches.size(); ++i)
+	{
+		if (m_batches[i].texture == texture && m_batches[i].layer == layer) { return i; }
+	}
+
+	m_batches.emplace_back();
+	m_batches.back().texture = texture;
+	m_batches.back().layer = layer;
+
+	uint32_t index = (uint32_t)m_batches.size() - 1;
+	m_drawOrder.push_back(index);
+	std::sort(m_drawOrder.begin(), m_drawOrder.end(), [this](uint32_t a, uint32_t b)
+	{
+		if (m_batches[a].layer != m_batches[b].layer) { return m_batches[a].layer < m_batches[b].layer; }
+		return std::less<const sf::Texture*>()(m_batches[a].texture, m_batches[b].texture);
+	});
+	return index;
+}
+
+void SpriteBatch::removeQuad(Slot& slot)
+{
+	// move the batch's last quad into the removed one's place
+	Batch& batch = m_batches[slot.batch];
+	size_t last = batch.entities.size() - 1;
+	if (slot.quad != last)
+	{
+		std::copy(batch.vertices.begin() + last * 4, batch.vertices.begin() + last * 4 + 4, batch.vertices.begin() + slot.quad * 4);
+		batch.entities[slot.quad] = batch.entities[last];
+		m_slots[batch.entities[slot.quad].index].quad = slot.quad;
+		markDirty(batch, slot.quad);
+	}
+	batch.vertices.resize(last * 4);
+	batch.entities.pop_back();
+	if (batch.dirtyEnd > last) { batch.dirtyEnd = last; }
+	if (batch.dirtyBegin > batch.dirtyEnd) { batch.dirtyBegin = batch.dirtyEnd; }
+
+	slot.batch = NoBatch;
+}
+
+void SpriteBatch::writeQuad(Batch& batch, uint32_t quad, const sf::Sprite& sprite)
+{
+	// the same corners and texture coordinates sf::Sprite uses, in quad order
+	const sf::IntRect& rect = sprite.getTextureRect();
+	float width = (float)std::abs(rect.width);
+	float height = (float)std::abs(rect.height);
+	float left = (float)rect.left;
+	float right = left + rect.width;
+	float top = (float)rect.top;
+	float bottom = top + rect.height;
+	const sf::Transform& transform = sprite.getTransform();
+	sf::Color color = sprite.getColor();
+
+	sf::Vertex* v = &batch.vertices[(size_t)quad * 4];
+	v[0] = sf::Vertex(transform.transformPoint(0, 0), color, sf::Vector2f(left, top));
+	v[1] = sf::Vertex(transform.transformPoint(width, 0), color, sf::Vector2f(right, top));
+	v[2] = sf::Vertex(transform.transformPoint(width, height), color, sf::Vector2f(right, bottom));
+	v[3] = sf::Vertex(transform.transformPoint(0, height), color, sf::Vector2f(left, bottom));
+	markDirty(batch, quad);
+}
+
+void SpriteBatch::begin()
+{
+	++m_frame;
+	m_shapes.clear();
+	m_drawCalls = 0;
+	m_quadsRebuilt = 0;
+	m_spritesAdded = 0;
+}
+
+void SpriteBatch::add(EntityHandle entity, int layer, const sf::Sprite& sprite)
+{
+	if (!entity.isValid() || !sprite.getTexture()) { return; }
+	if (entity.index >= m_slots.size()) { m_slots.resize((size_t)entity.index + 1); }
+	++m_spritesAdded;
+
+	// a reused slot belongs to a new entity, whatever the old one had is thrown away
+	Slot& slot = m_slots[entity.index];
+	if (slot.generation != entity.generation)
+	{
+		if (slot.batch != NoBatch) { removeQuad(slot); }
+		slot.generation = entity.generation;
+	}
+	slot.frame = m_frame;
+
+	SpriteKey key;
+	key.texture = sprite.getTexture();
+	key.rect = sprite.getTextureRect();
+	key.position = sprite.getPosition();
+	key.origin = sprite.getOrigin();
+	key.scale = sprite.getScale();
+	key.rotation = sprite.getRotation();
+	key.color = sprite.getColor();
+
+	// most sprites stay in the batch they were in, only look one up when the texture or layer changed
+	uint32_t batchIndex = slot.batch;
+	if (batchIndex == NoBatch || m_batches[batchIndex].texture != key.texture || m_batches[batchIndex].layer != layer)
+	{
+		batchIndex = batchFor(key.texture, layer);
+	}
+	if (slot.batch == batchIndex && slot.key == key) { return; }
+
+	if (slot.batch != batchIndex)
+	{
+		if (slot.batch != NoBatch) { removeQuad(slot); }
+		Batch& batch = m_batches[batchIndex];
+		slot.batch = batchIndex;
+		slot.quad = (uint32_t)batch.entities.size();
+		batch.entities.push_back(entity);
+		batch.vertices.resize(batch.vertices.size() + 4);
+	}
+	writeQuad(m_batches[batchIndex], slot.quad, sprite);
+	slot.key = key;
+	++m_quadsRebuilt;
+}
+
+void SpriteBatch::end()
+{
+	for (Slot& slot : m_slots)
+	{
+		if (slot.batch != NoBatch && slot.frame != m_frame) { removeQuad(slot); }
+	}
+}
+
+void SpriteBatch::addRect(const sf::FloatRect& rect, const sf::Color& color, float thickness, const sf::Transform& transform)
+{
+	auto quad = [&](float left, float top, float right, float bottom)
+	{
+		m_shapes.push_back(sf::Vertex(transform.transformPoint(left, top), color));
+		m_shapes.push_back(sf::Vertex(transform.transformPoint(right, top), color));
+		m_shapes.push_back(sf::Vertex(transform.transformPoint(right, bottom), color));
+		m_shapes.push_back(sf::Vertex(transform.transformPoint(left, bottom), color));
+	};
+
+	float left = rect.left;
+	float top = rect.top;
+	float right = rect.left + rect.width;
+	float bottom = rect.top + rect.height;
+	if (thickness <= 0)
+	{
+		quad(left, top, right, bottom);
+		return;
+	}
+
+	// an outline drawn outside the rectangle like sf::RectangleShape's, as four strips
+	quad(left - thickness, top - thickness, right + thickness, top);
+	quad(left - thickness, bottom, right + thickness, bottom + thickness);
+	quad(left - thickness, top, left, bottom);
+	quad(right, top, right + thickness, bottom);
+}
+
+void SpriteBatch::draw(sf::RenderTarget& target)
+{
+	// asked here rather than in the constructor because it needs a graphics context
+	if (!m_checkedBuffers)
+	{
+		m_useBuffers = sf::VertexBuffer::isAvailable();
+		m_checkedBuffers = true;
+	}
+
+	for (uint32_t index : m_drawOrder)
+	{
+		Batch& batch = m_batches[index];
+		if (batch.entities.empty()) { continue; }
+
+		sf::RenderStates states;
+		states.texture = batch.texture;
+		if (!m_useBuffers)
+		{
+			target.draw(batch.vertices.data(), batch.vertices.size(), sf::Quads, states);
+			++m_drawCalls;
+			continue;
+		}
+
+		// grow the buffer to double what is needed so adding a few sprites doesn't reallocate it every frame
+		if (batch.buffer.getVertexCount() < batch.vertices.size())
+		{
+			batch.buffer.create(batch.vertices.size() * 2);
+			batch.dirtyBegin = 0;
+			batch.dirtyEnd = batch.entities.size();
+		}
+		if (batch.dirtyBegin != batch.dirtyEnd)
+		{
+			batch.buffer.update(&batch.vertices[batch.dirtyBegin * 4], (batch.dirtyEnd - batch.dirtyBegin) * 4, (unsigned int)(batch.dirtyBegin * 4));
+			batch.dirtyBegin = batch.dirtyEnd = 0;
+		}
+		target.draw(batch.buffer, 0, batch.vertices.size(), states);
+		++m_drawCalls;
+	}
+
+	if (!m_shapes.empty())
+	{
+		target.draw(m_shapes.data(), m_shapes.size(), sf::Quads);
+		++m_drawCalls;
+	}
+}
+
+void SpriteBatch::clear()
+{
+	m_slots.clear();
+	m_batches.clear();
+	m_drawOrder.clear();
+	m_shapes.clear();
+}
+
+size_t SpriteBatch::drawCalls() const
+{
+	return m_drawCalls;
+}
+
+size_t SpriteBatch::quadsRebuilt() const
+{
+	return m_quadsRebuilt;
+}
+
+size_t SpriteBatch::spritesAdded() const
+{
+	return m_spritesAdded;
+}
+
+size_t SpriteBatch::batchCount() const
+{
+	return m_batches.size();
+}
\ No newline at end of file
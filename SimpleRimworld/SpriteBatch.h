@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Entity.h"
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+
+// Draws entity sprites with one draw call per texture per layer instead of one per sprite.
+//
+// Every entity's sprite is a quad in the batch for its texture and layer. Each frame the scene calls
+// begin(), add() for every entity it wants drawn and end(). add() compares the sprite against what
+// its quad was built from and only rewrites the quad when something changed, so a map of tiles that
+// don't move costs a comparison per tile and no vertex work. end() drops the quads of entities that
+// weren't added this frame. Only the range of quads that changed is uploaded to the vertex buffer.
+//
+// Layers are drawn in increasing order and within a layer the batches are drawn by texture, so
+// sprites that overlap should be put on different layers. Untextured rectangles added with addRect()
+// are rebuilt every frame and drawn after every sprite in a single call.
+class SpriteBatch
+{
+	static constexpr uint32_t NoBatch = UINT32_MAX;
+
+	// everything that decides where a sprite's quad goes and what it shows
+	struct SpriteKey
+	{
+		const sf::Texture* texture = nullptr;
+		sf::IntRect        rect;
+		sf::Vector2f       position;
+		sf::Vector2f       origin;
+		sf::Vector2f       scale;
+		float              rotation = 0;
+		sf::Color          color;
+
+		bool operator == (const SpriteKey& rhs) const;
+	};
+
+	struct Slot
+	{
+		uint32_t  generation = 0;
+		uint32_t  batch = NoBatch;
+		uint32_t  quad = 0;
+		uint32_t  frame = 0;       // the last frame the entity was added in
+		SpriteKey key;
+	};
+
+	struct Batch
+	{
+		const sf::Texture*        texture = nullptr;
+		int                       layer = 0;
+		std::vector<sf::Vertex>   vertices;    // four per quad
+		std::vector<EntityHandle> entities;    // the entity each quad belongs to
+		sf::VertexBuffer          buffer = sf::VertexBuffer(sf::Quads, sf::VertexBuffer::Dynamic);
+		size_t                    dirtyBegin = 0;  // range of quads to upload, empty when begin == end
+		size_t                    dirtyEnd = 0;
+	};
+
+	std::vector<Slot>       m_slots;       // indexed by entity index
+	std::deque<Batch>       m_batches;     // a deque so batches never move and their buffers aren't copied
+	std::vector<uint32_t>   m_drawOrder;   // batch indices sorted by layer then texture
+	std::vector<sf::Vertex> m_shapes;
+	uint32_t                m_frame = 0;
+	bool                    m_useBuffers = false;
+	bool                    m_checkedBuffers = false;
+
+	size_t                  m_drawCalls = 0;
+	size_t                  m_quadsRebuilt = 0;
+	size_t                  m_spritesAdded = 0;
+
+	uint32_t batchFor(const sf::Texture* texture, int layer);
+	void removeQuad(Slot& slot);
+	void writeQuad(Batch& batch, uint32_t quad, const sf::Sprite& sprite);
+	static void markDirty(Batch& batch, size_t quad);
+
+public:
+
+	SpriteBatch();
+
+	void begin();
+	void add(EntityHandle entity, int layer, const sf::Sprite& sprite);
+	void end();
+
+	// A filled rectangle, or its outline when thickness is above zero, drawn after the sprites this frame.
+	void addRect(const sf::FloatRect& rect, const sf::Color& color, float thickness = 0, const sf::Transform& transform = sf::Transform::Identity);
+
+	void draw(sf::RenderTarget& target);
+	void clear();
+
+	// counters for the last frame drawn
+	size_t drawCalls() const;
+	size_t quadsRebuilt() const;
+	size_t spritesAdded() const;
+	size_t batchCount() const;
+};
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "TextureAtlas.h"
+
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+// imgui_draw.cpp compiles its own copy of stb_rect_pack as static functions, so this one is static too
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+TextureAtlas::TextureAtlas(int pageSize)
+	: m_pageSize(pageSize)
+{
+
+}
+
+std::string TextureAtlas::pagePath(const std::string& layoutPath, size_t page) const
+{
+	size_t dot = layoutPath.find_last_of('.');
+	std::string stem = dot == std::string::npos ? layoutPath : layoutPath.substr(0, dot);
+	return stem + "_" + std::to_string(page) + ".png";
+}
+
+void TextureAtlas::add(const std::string& name, const sf::Image& source, const sf::IntRect& rect)
+{
+	m_pending.push_back({ name, &source, rect });
+}
+
+bool TextureAtlas::build()
+{
+	std::vector<stbrp_rect> remaining(m_pending.size());
+	for (size_t i = 0; i < m_pending.size(); ++i)
+	{
+		remaining[i].id = (int)i;
+		remaining[i].w = m_pending[i].rect.width + Padding * 2;
+		remaining[i].h = m_pending[i].rect.height + Padding * 2;
+	}
+
+	// fill a page, then start another with whatever didn't fit
+	bool allPacked = true;
+	std::vector<stbrp_node> nodes((size_t)m_pageSize);
+	while (!remaining.empty())
+	{
+		stbrp_context context;
+		stbrp_init_target(&context, m_pageSize, m_pageSize, nodes.data(), (int)nodes.size());
+		stbrp_pack_rects(&context, remaining.data(), (int)remaining.size());
+
+		std::vector<stbrp_rect> packed, unpacked;
+		int usedWidth = 1, usedHeight = 1;
+		for (const stbrp_rect& rect : remaining)
+		{
+			if (!rect.was_packed) { unpacked.push_back(rect); continue; }
+			packed.push_back(rect);
+			usedWidth = std::max(usedWidth, rect.x + rect.w);
+			usedHeight = std::max(usedHeight, rect.y + rect.h);
+		}
+
+		// nothing fit on an empty page, so the rest are bigger than a page
+		if (packed.empty())
+		{
+			for (const stbrp_rect& rect : unpacked)
+			{
+				std::cerr << "Image " << m_pending[rect.id].name << " is too big for a " << m_pageSize << " pixel atlas page" << std::endl;
+			}
+			allPacked = false;
+			break;
+		}
+
+		// the page only needs to be as big as what was packed into it
+		size_t page = m_pages.size();
+		m_pages.emplace_back();
+		m_pageImages.emplace_back();
+		sf::Image& pageImage = m_pageImages.back();
+		pageImage.create((unsigned int)usedWidth, (unsigned int)usedHeight, sf::Color::Transparent);
+
+		for (const stbrp_rect& rect : packed)
+		{
+			const Pending& pending = m_pending[rect.id];
+			int x = rect.x + Padding;
+			int y = rect.y + Padding;
+			int width = pending.rect.width;
+			int height = pending.rect.height;
+			pageImage.copy(*pending.source, x, y, pending.rect);
+
+			// repeat the edge columns, then the edge rows including the repeated columns, into the padding
+			for (int p = 1; p <= Padding; ++p)
+			{
+				pageImage.copy(pageImage, x - p, y, sf::IntRect(x, y, 1, height));
+				pageImage.copy(pageImage, x + width - 1 + p, y, sf::IntRect(x + width - 1, y, 1, height));
+			}
+			for (int p = 1; p <= Padding; ++p)
+			{
+				pageImage.copy(pageImage, x - Padding, y - p, sf::IntRect(x - Padding, y, width + Padding * 2, 1));
+				pageImage.copy(pageImage, x - Padding, y + height - 1 + p, sf::IntRect(x - Padding, y + height - 1, width + Padding * 2, 1));
+			}
+
+			m_regions[pending.name] = { page, sf::IntRect(x, y, width, height) };
+		}
+		remaining.swap(unpacked);
+	}
+
+	m_pending.clear();
+	return allPacked;
+}
+
+bool TextureAtlas::save(const std::string& layoutPath, uint64_t key) const
+{
+	if (m_uploadedPages > 0)
+	{
+		std::cerr << "Atlas pages have already been uploaded and can't be saved" << std::endl;
+		return false;
+	}
+
+	for (size_t i = 0; i < m_pageImages.size(); ++i)
+	{
+		if (!m_pageImages[i].saveToFile(pagePath(layoutPath, i))) { return false; }
+	}
+
+	std::ofstream file(layoutPath);
+	if (!file) { return false; }
+	file << "Atlas " << key << " " << m_pageImages.size() << "\n";
+	for (const auto& [name, region] : m_regions)
+	{
+		file << "Region " << name << " " << region.page << " " << region.rect.left << " " << region.rect.top
+			<< " " << region.rect.width << " " << region.rect.height << "\n";
+	}
+	return file.good();
+}
+
+bool TextureAtlas::load(const std::string& layoutPath, uint64_t key)
+{
+	std::ifstream file(layoutPath);
+	if (!file) { return false; }
+
+	std::string token;
+	uint64_t savedKey = 0;
+	size_t pageCount = 0;
+	if (!(file >> token >> savedKey >> pageCount) || token != "Atlas" || savedKey != key) { return false; }
+
+	std::vector<sf::Image> pageImages(pageCount);
+	for (size_t i = 0; i < pageCount; ++i)
+	{
+		if (!pageImages[i].loadFromFile(pagePath(layoutPath, i))) { return false; }
+	}
+
+	std::map<std::string, AtlasRegion> regions;
+	std::string name;
+	AtlasRegion region;
+	while (file >> token >> name >> region.page >> region.rect.left >> region.rect.top >> region.rect.width >> region.rect.height)
+	{
+		if (token != "Region" || region.page >= pageCount) { return false; }
+		regions[name] = region;
+	}
+
+	clear();
+	m_pageImages.swap(pageImages);
+	m_pages.resize(pageCount);
+	m_regions.swap(regions);
+	return true;
+}
+
+void TextureAtlas::upload()
+{
+	// a build after an upload only adds images for its new pages
+	for (size_t i = 0; i < m_pageImages.size(); ++i)
+	{
+		size_t page = m_uploadedPages + i;
+		if (!m_pages[page].loadFromImage(m_pageImages[i]))
+		{
+			std::cerr << "Could not create atlas page " << page << std::endl;
+		}
+	}
+	m_uploadedPages += m_pageImages.size();
+	m_pageImages.clear();
+}
+
+void TextureAtlas::clear()
+{
+	m_pending.clear();
+	m_pageImages.clear();
+	m_pages.clear();
+	m_regions.clear();
+	m_uploadedPages = 0;
+}
+
+const AtlasRegion* TextureAtlas::region(const std::string& name) const
+{
+	auto it = m_regions.find(name);
+	return it == m_regions.end() ? nullptr : &it->second;
+}
+
+const sf::Texture& TextureAtlas::page(size_t page) const
+{
+	return m_pages[page];
+}
+
+size_t TextureAtlas::pageCount() const
+{
+	return m_pages.size();
+}
+
+const std::map<std::string, AtlasRegion>& TextureAtlas::regions() const
+{
+	return m_regions;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Where an image was put in the atlas.
+struct AtlasRegion
+{
+	size_t      page = 0;
+	sf::IntRect rect;
+};
+
+// Packs many small images into a few large textures so sprites cut from different images share a
+// texture and can be drawn together.
+//
+// Images are added by name and placed by build(), which packs them with stb_rect_pack into as few pages
+// as it can. Every image gets a Padding pixel border repeating its own edge pixels, so a sprite drawn at
+// a fractional position never samples its neighbour.
+//
+// A built atlas can be saved as page images plus a text layout and loaded back later without cutting
+// or packing anything. The layout records a key, normally a hash of everything the atlas was built from,
+// and load() only accepts a layout saved with the same key.
+class TextureAtlas
+{
+public:
+
+	static constexpr int Padding = 1;
+
+private:
+
+	struct Pending
+	{
+		std::string      name;
+		const sf::Image* source = nullptr;
+		sf::IntRect      rect;
+	};
+
+	int                                m_pageSize = 2048;
+	std::vector<Pending>               m_pending;
+	std::vector<sf::Image>             m_pageImages;  // the pages from m_uploadedPages on, kept until upload()
+	std::deque<sf::Texture>            m_pages;       // a deque so sprites can keep pointers to the pages
+	size_t                             m_uploadedPages = 0;
+	std::map<std::string, AtlasRegion> m_regions;
+
+	std::string pagePath(const std::string& layoutPath, size_t page) const;
+
+public:
+
+	TextureAtlas(int pageSize = 2048);
+
+	// Queues rect of source to be packed by the next build(). Nothing is copied until then, so source has
+	// to outlive the build.
+	void add(const std::string& name, const sf::Image& source, const sf::IntRect& rect);
+
+	// Packs everything added since the last build into new pages. Returns false if an image didn't fit
+	// in a page, in which case it is left out.
+	bool build();
+
+	bool save(const std::string& layoutPath, uint64_t key) const;
+	bool load(const std::string& layoutPath, uint64_t key);
+
+	// Creates the textures of the pages built since the last upload and frees their images. Needs a graphics context.
+	void upload();
+	void clear();
+
+	const AtlasRegion* region(const std::string& name) const;
+	const sf::Texture& page(size_t page) const;
+	size_t pageCount() const;
+	const std::map<std::string, AtlasRegion>& regions() const;
+};
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "TileGrid.h"
+
+#include <cmath>
+#include <algorithm>
+
+TileGrid::TileGrid()
+{
+
+}
+
+TileGrid::TileGrid(int width, int height, const Vec2& cellSize)
+	: m_cellSize(cellSize)
+{
+	resize(width, height);
+}
+
+size_t TileGrid::cellIndex(int x, int y) const
+{
+	return (size_t)y * m_width + x;
+}
+
+bool TileGrid::testBit(const std::vector<uint64_t>& bits, size_t index)
+{
+	return (bits[index / WordBits] >> (index % WordBits)) & 1;
+}
+
+void TileGrid::setBit(std::vector<uint64_t>& bits, size_t index, bool value)
+{
+	uint64_t mask = (uint64_t)1 << (index % WordBits);
+	if (value) { bits[index / WordBits] |= mask; }
+	else	   { bits[index / WordBits] &= ~mask; }
+}
+
+void TileGrid::resize(int width, int height)
+{
+	if (width < 0) { width = 0; }
+	if (height < 0) { height = 0; }
+	if (width == m_width && height == m_height) { return; }
+
+	size_t cells = (size_t)width * height;
+	size_t words = (cells + WordBits - 1) / WordBits;
+
+	std::vector<uint64_t> occupied(words, 0);
+	std::vector<uint64_t> blockMove(words, 0);
+	std::vector<uint64_t> blockVision(words, 0);
+	std::vector<EntityHandle> entities(cells);
+	std::vector<AnimationId> animations(cells);
+
+	// copy the cells the old and new grid have in common
+	int copyWidth = width < m_width ? width : m_width;
+	int copyHeight = height < m_height ? height : m_height;
+	for (int y = 0; y < copyHeight; ++y)
+	{
+		for (int x = 0; x < copyWidth; ++x)
+		{
+			size_t from = cellIndex(x, y);
+			size_t to = (size_t)y * width + x;
+			setBit(occupied, to, testBit(m_occupied, from));
+			setBit(blockMove, to, testBit(m_blockMove, from));
+			setBit(blockVision, to, testBit(m_blockVision, from));
+			entities[to] = m_entities[from];
+			animations[to] = m_animations[from];
+		}
+	}
+
+	m_width = width;
+	m_height = height;
+	m_occupied.swap(occupied);
+	m_blockMove.swap(blockMove);
+	m_blockVision.swap(blockVision);
+	m_entities.swap(entities);
+	m_animations.swap(animations);
+	resetChangeLogs();
+}
+
+void TileGrid::clear()
+{
+	std::fill(m_occupied.begin(), m_occupied.end(), 0);
+	std::fill(m_blockMove.begin(), m_blockMove.end(), 0);
+	std::fill(m_blockVision.begin(), m_blockVision.end(), 0);
+	std::fill(m_entities.begin(), m_entities.end(), EntityHandle());
+	std::fill(m_animations.begin(), m_animations.end(), AnimationId());
+	resetChangeLogs();
+}
+
+void TileGrid::ChangeLog::add(int x, int y)
+{
+	++version;
+
+	// once the log is full start it over, anything further behind than that rebuilds from scratch
+	if (cells.size() >= MaxChangeLog)
+	{
+		cells.clear();
+		start = version;
+		return;
+	}
+	cells.push_back({ x, y });
+}
+
+void TileGrid::ChangeLog::reset()
+{
+	++version;
+	cells.clear();
+	start = version;
+}
+
+bool TileGrid::ChangeLog::since(size_t from, std::vector<GridCell>& out) const
+{
+	if (from < start || from > version) { return false; }
+
+	// the entry at index i is the change that produced version start + i + 1
+	for (size_t i = from - start; i < cells.size(); ++i)
+	{
+		out.push_back(cells[i]);
+	}
+	return true;
+}
+
+void TileGrid::resetChangeLogs()
+{
+	m_moveLog.reset();
+	m_visionLog.reset();
+}
+
+bool TileGrid::set(int x, int y, EntityHandle entity, AnimationId animation, bool blockMove, bool blockVision)
+{
+	if (x < 0 || y < 0) { return false; }
+
+	// Grow by at least double so a level loaded one cell at a time doesn't copy the grid for every new column
+	if (x >= m_width || y >= m_height)
+	{
+		int width = m_width;
+		int height = m_height;
+		if (x >= width) { width = x + 1 > width * 2 ? x + 1 : width * 2; }
+		if (y >= height) { height = y + 1 > height * 2 ? y + 1 : height * 2; }
+		resize(width, height);
+	}
+
+	size_t index = cellIndex(x, y);
+	if (testBit(m_blockMove, index) != blockMove) { m_moveLog.add(x, y); }
+	if (testBit(m_blockVision, index) != blockVision) { m_visionLog.add(x, y); }
+	setBit(m_occupied, index, true);
+	setBit(m_blockMove, index, blockMove);
+	setBit(m_blockVision, index, blockVision);
+	m_entities[index] = entity;
+	m_animations[index] = animation;
+	return true;
+}
+
+void TileGrid::fitToContents()
+{
+	int width = 0;
+	int height = 0;
+	for (size_t word = 0; word < m_occupied.size(); ++word)
+	{
+		// empty words are skipped whole, most of the grid past the level is empty
+		uint64_t bits = m_occupied[word];
+		for (size_t bit = 0; bits != 0; ++bit, bits >>= 1)
+		{
+			if (!(bits & 1)) { continue; }
+			size_t index = word * WordBits + bit;
+			int x = (int)(index % m_width);
+			int y = (int)(index / m_width);
+			if (x >= width) { width = x + 1; }
+			if (y >= height) { height = y + 1; }
+		}
+	}
+	resize(width, height);
+}
+
+void TileGrid::clear(int x, int y, EntityHandle entity)
+{
+	if (!inBounds(x, y)) { return; }
+
+	size_t index = cellIndex(x, y);
+	if (m_entities[index] != entity) { return; }
+	if (testBit(m_blockMove, index)) { m_moveLog.add(x, y); }
+	if (testBit(m_blockVision, index)) { m_visionLog.add(x, y); }
+
+	setBit(m_occupied, index, false);
+	setBit(m_blockMove, index, false);
+	setBit(m_blockVision, index, false);
+	m_entities[index] = EntityHandle();
+	m_animations[index] = AnimationId();
+}
+
+bool TileGrid::inBounds(int x, int y) const
+{
+	return x >= 0 && y >= 0 && x < m_width && y < m_height;
+}
+
+bool TileGrid::occupied(int x, int y) const
+{
+	return inBounds(x, y) && testBit(m_occupied, cellIndex(x, y));
+}
+
+bool TileGrid::blocksMove(int x, int y) const
+{
+	return !inBounds(x, y) || testBit(m_blockMove, cellIndex(x, y));
+}
+
+bool TileGrid::blocksVision(int x, int y) const
+{
+	return !inBounds(x, y) || testBit(m_blockVision, cellIndex(x, y));
+}
+
+EntityHandle TileGrid::entity(int x, int y) const
+{
+	return inBounds(x, y) ? m_entities[cellIndex(x, y)] : EntityHandle();
+}
+
+AnimationId TileGrid::animation(int x, int y) const
+{
+	return inBounds(x, y) ? m_animations[cellIndex(x, y)] : AnimationId();
+}
+
+void TileGrid::worldToCell(const Vec2& pos, int& x, int& y) const
+{
+	x = (int)std::floor(pos.x / m_cellSize.x);
+	y = (int)std::floor(pos.y / m_cellSize.y);
+}
+
+Vec2 TileGrid::cellCenter(int x, int y) const
+{
+	return Vec2(x * m_cellSize.x + m_cellSize.x / 2, y * m_cellSize.y + m_cellSize.y / 2);
+}
+
+size_t TileGrid::moveVersion() const
+{
+	return m_moveLog.version;
+}
+
+bool TileGrid::moveChangesSince(size_t version, std::vector<GridCell>& out) const
+{
+	return m_moveLog.since(version, out);
+}
+
+const std::vector<uint64_t>& TileGrid::blockMoveBits() const
+{
+	return m_blockMove;
+}
+
+size_t TileGrid::visionVersion() const
+{
+	return m_visionLog.version;
+}
+
+bool TileGrid::visionChangesSince(size_t version, std::vector<GridCell>& out) const
+{
+	return m_visionLog.since(version, out);
+}
+
+const std::vector<uint64_t>& TileGrid::blockVisionBits() const
+{
+	return m_blockVision;
+}
+
+int TileGrid::width() const
+{
+	return m_width;
+}
+
+int TileGrid::height() const
+{
+	return m_height;
+}
+
+const Vec2& TileGrid::cellSize() const
+{
+	return m_cellSize;
+}
+
+size_t TileGrid::memoryUsage() const
+{
+	size_t bytes = (m_occupied.capacity() + m_blockMove.capacity() + m_blockVision.capacity()) * sizeof(uint64_t);
+	bytes += m_entities.capacity() * sizeof(EntityHandle);
+	bytes += m_animations.capacity() * sizeof(AnimationId);
+	return bytes;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Entity.h"
+#include "AssetId.h"
+#include "Vec2.h"
+
+#include <vector>
+#include <cstdint>
+
+struct GridCell
+{
+	int x = 0;
+	int y = 0;
+
+	bool operator == (const GridCell& rhs) const { return x == rhs.x && y == rhs.y; }
+	bool operator != (const GridCell& rhs) const { return !(*this == rhs); }
+};
+
+// A dense grid with one cell per map grid square for the entities that sit on the grid (Tiles and Decorations).
+// The blocking flags are kept in bit planes, one bit per cell, so pathfinding and vision can read whole
+// rows of the map from a few cache lines. The entity handle and animation of each cell live in their own
+// arrays and are only touched when something needs to know what is in a cell.
+//
+// Every query is a direct index into the arrays. Cells outside the grid block movement and vision
+// and are never occupied.
+class TileGrid
+{
+	static constexpr size_t WordBits = 64;
+	static constexpr size_t MaxChangeLog = 4096;
+
+	// The cells behind the last few thousand changes to one of the blocking planes. Every change bumps
+	// the version, so anything built from the plane can tell it is stale and find out where.
+	struct ChangeLog
+	{
+		size_t                version = 0;
+		size_t                start = 0;   // the version cells starts after
+		std::vector<GridCell> cells;       // the cell behind each version bump since start
+
+		void add(int x, int y);
+		void reset();
+		bool since(size_t version, std::vector<GridCell>& out) const;
+	};
+
+	int                                              m_width = 0;
+	int                                              m_height = 0;
+	Vec2                                             m_cellSize = { 64, 64 };
+	std::vector<uint64_t>                            m_occupied;     // bit per cell, set when an entity is in the cell
+	std::vector<uint64_t>                            m_blockMove;    // bit per cell
+	std::vector<uint64_t>                            m_blockVision;  // bit per cell
+	std::vector<EntityHandle>                        m_entities;     // the entity in each cell
+	std::vector<AnimationId>                         m_animations;   // the animation of each cell, invalid when empty
+	ChangeLog                                        m_moveLog;      // bumped whenever a blockMove bit changes
+	ChangeLog                                        m_visionLog;    // bumped whenever a blockVision bit changes
+
+	size_t cellIndex(int x, int y) const;
+	static bool testBit(const std::vector<uint64_t>& bits, size_t index);
+	static void setBit(std::vector<uint64_t>& bits, size_t index, bool value);
+	void resetChangeLogs();
+
+public:
+
+	TileGrid();
+	TileGrid(int width, int height, const Vec2& cellSize);
+
+	// Changes the size of the grid. Cells inside both the old and new size keep their contents.
+	void resize(int width, int height);
+	void clear();
+
+	// Puts an entity in a cell, growing the grid if the cell is past its right or bottom edge.
+	// Returns false for negative cell coordinates, which the grid can't hold. The grid grows by
+	// doubling so loading a level doesn't copy it for every new row, which leaves empty walkable
+	// cells past the level, so call fitToContents() once the level is loaded.
+	bool set(int x, int y, EntityHandle entity, AnimationId animation, bool blockMove, bool blockVision);
+
+	// Shrinks the grid to the smallest size that holds every occupied cell.
+	void fitToContents();
+
+	// Empties a cell. Does nothing if the cell holds a different entity than the one given.
+	void clear(int x, int y, EntityHandle entity);
+
+	bool inBounds(int x, int y) const;
+	bool occupied(int x, int y) const;
+	bool blocksMove(int x, int y) const;
+	bool blocksVision(int x, int y) const;
+	EntityHandle entity(int x, int y) const;
+	AnimationId animation(int x, int y) const;
+
+	// The cell a world position falls in and the world position of a cell's center.
+	void worldToCell(const Vec2& pos, int& x, int& y) const;
+	Vec2 cellCenter(int x, int y) const;
+
+	// Changes whenever any cell starts or stops blocking movement, so anything caching
+	// routes over the grid can tell when its results may be stale.
+	size_t moveVersion() const;
+
+	// Appends the cells whose blockMove bit changed after the given moveVersion() to out. Returns false
+	// when the log doesn't reach back that far or the whole grid changed since, in which case the caller
+	// has to treat every cell as changed.
+	bool moveChangesSince(size_t version, std::vector<GridCell>& out) const;
+
+	// The blockMove plane, one bit per cell in row order. Cheap to copy for work done off the main thread.
+	const std::vector<uint64_t>& blockMoveBits() const;
+
+	// The same for blockVision, used by anything caching what can be seen.
+	size_t visionVersion() const;
+	bool visionChangesSince(size_t version, std::vector<GridCell>& out) const;
+	const std::vector<uint64_t>& blockVisionBits() const;
+
+	int width() const;
+	int height() const;
+	const Vec2& cellSize() const;
+	size_t memoryUsage() const;
+};
\ No newline at end of file
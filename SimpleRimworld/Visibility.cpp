@@ -0,0 +1,300 @@
+#include "Visibility.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+namespace
+{
+	// how an octant's rows and columns map onto the grid, one column of the table per octant
+	const int OctantXX[8] = { 1, 0, 0, -1, -1, 0, 0, 1 };
+	const int OctantXY[8] = { 0, 1, -1, 0, 0, -1, 1, 0 };
+	const int OctantYX[8] = { 0, 1, 1, 0, 0, -1, -1, 0 };
+	const int OctantYY[8] = { 1, 0, 0, 1, -1, 0, 0, -1 };
+}
+
+bool FieldOfView::sees(int x, int y) const
+{
+	int side = radius * 2 + 1;
+	int dx = x - origin.x + radius;
+	int dy = y - origin.y + radius;
+	if (bits.empty() || dx < 0 || dy < 0 || dx >= side || dy >= side) { return false; }
+
+	size_t index = (size_t)dy * side + dx;
+	return (bits[index / 64] >> (index % 64)) & 1;
+}
+
+Visibility::Visibility()
+{
+
+}
+
+Visibility::Visibility(const TileGrid& grid)
+	: m_grid(&grid)
+{
+
+}
+
+uint64_t Visibility::key(EntityHandle entity)
+{
+	return ((uint64_t)entity.generation << 32) | entity.index;
+}
+
+bool Visibility::blocked(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= m_width || y >= m_height) { return true; }
+	return m_blocked[(size_t)y * m_width + x] != 0;
+}
+
+void Visibility::rebuild()
+{
+	const TileGrid& grid = *m_grid;
+	m_width = grid.width();
+	m_height = grid.height();
+
+	const std::vector<uint64_t>& bits = grid.blockVisionBits();
+	size_t cells = (size_t)m_width * m_height;
+	m_blocked.resize(cells);
+	for (size_t i = 0; i < cells; ++i)
+	{
+		m_blocked[i] = (bits[i / 64] >> (i % 64)) & 1;
+	}
+}
+
+void Visibility::sync()
+{
+	const TileGrid& grid = *m_grid;
+	if (grid.visionVersion() == m_gridVersion) { return; }
+
+	m_changes.clear();
+	if (grid.width() != m_width || grid.height() != m_height || !grid.visionChangesSince(m_gridVersion, m_changes))
+	{
+		rebuild();
+		for (CachedView& cached : m_views) { cached.stale = true; }
+	}
+	else
+	{
+		// a cell can only change what an observer sees if it is inside the observer's radius
+		for (const GridCell& cell : m_changes)
+		{
+			m_blocked[(size_t)cell.y * m_width + cell.x] = grid.blocksVision(cell.x, cell.y) ? 1 : 0;
+			for (CachedView& cached : m_views)
+			{
+				const FieldOfView& view = cached.view;
+				if (std::abs(cell.x - view.origin.x) <= view.radius && std::abs(cell.y - view.origin.y) <= view.radius)
+				{
+					cached.stale = true;
+				}
+			}
+		}
+	}
+	m_gridVersion = grid.visionVersion();
+}
+
+bool Visibility::lineOfSight(int x0, int y0, int x1, int y1)
+{
+	sync();
+
+	// Bresenham's line, checking every cell after the first until the last
+	int dx = std::abs(x1 - x0);
+	int dy = -std::abs(y1 - y0);
+	int sx = x0 < x1 ? 1 : -1;
+	int sy = y0 < y1 ? 1 : -1;
+	int error = dx + dy;
+	int x = x0;
+	int y = y0;
+	while (x != x1 || y != y1)
+	{
+		int error2 = error * 2;
+		if (error2 >= dy) { error += dy; x += sx; }
+		if (error2 <= dx) { error += dx; y += sy; }
+		if ((x != x1 || y != y1) && blocked(x, y)) { return false; }
+	}
+	return true;
+}
+
+bool Visibility::lineOfSight(const Vec2& from, const Vec2& to)
+{
+	sync();
+
+	const Vec2& cellSize = m_grid->cellSize();
+	int x, y, endX, endY;
+	m_grid->worldToCell(from, x, y);
+	m_grid->worldToCell(to, endX, endY);
+
+	// Walk the cells the segment crosses in order (Amanatides and Woo). tMax is how far along the segment,
+	// from 0 to 1, the next vertical or horizontal cell edge is and tDelta how far apart those edges are.
+	Vec2 delta = to - from;
+	int stepX = delta.x > 0 ? 1 : -1;
+	int stepY = delta.y > 0 ? 1 : -1;
+	float tMaxX = INFINITY, tMaxY = INFINITY, tDeltaX = INFINITY, tDeltaY = INFINITY;
+	if (delta.x != 0)
+	{
+		tMaxX = ((x + (stepX > 0 ? 1 : 0)) * cellSize.x - from.x) / delta.x;
+		tDeltaX = cellSize.x / std::abs(delta.x);
+	}
+	if (delta.y != 0)
+	{
+		tMaxY = ((y + (stepY > 0 ? 1 : 0)) * cellSize.y - from.y) / delta.y;
+		tDeltaY = cellSize.y / std::abs(delta.y);
+	}
+
+	// the segment crosses exactly this many cell edges, which also keeps rounding from walking past the end
+	int steps = std::abs(endX - x) + std::abs(endY - y);
+	for (int i = 1; i < steps; ++i)
+	{
+		if (tMaxX < tMaxY) { x += stepX; tMaxX += tDeltaX; }
+		else			   { y += stepY; tMaxY += tDeltaY; }
+		if (blocked(x, y)) { return false; }
+	}
+	return true;
+}
+
+void Visibility::markVisible(FieldOfView& view, int x, int y)
+{
+	int side = view.radius * 2 + 1;
+	size_t index = (size_t)(y - view.origin.y + view.radius) * side + (x - view.origin.x + view.radius);
+	view.bits[index / 64] |= (uint64_t)1 << (index % 64);
+}
+
+void Visibility::castLight(FieldOfView& view, int row, float start, float end, int xx, int xy, int yx, int yy) const
+{
+	if (start < end) { return; }
+
+	int radius = view.radius;
+	int radiusSquared = radius * radius;
+	float newStart = 0;
+	for (int distance = row; distance <= radius; ++distance)
+	{
+		// Scan one row of the octant from its outer edge in toward the diagonal. Each cell covers a range
+		// of slopes, and only the cells whose range overlaps the part of the row still lit are looked at.
+		int dy = -distance;
+		bool inShadow = false;
+		for (int dx = -distance; dx <= 0; ++dx)
+		{
+			float leftSlope = (dx - 0.5f) / (dy + 0.5f);
+			float rightSlope = (dx + 0.5f) / (dy - 0.5f);
+			if (start < rightSlope) { continue; }
+			if (end > leftSlope) { break; }
+
+			int x = view.origin.x + dx * xx + dy * xy;
+			int y = view.origin.y + dx * yx + dy * yy;
+			bool opaque = blocked(x, y);
+			if (dx * dx + dy * dy <= radiusSquared && x >= 0 && y >= 0 && x < m_width && y < m_height)
+			{
+				markVisible(view, x, y);
+			}
+
+			if (inShadow)
+			{
+				// still running along a wall, the lit part of the row starts again after it
+				if (opaque) { newStart = rightSlope; continue; }
+				inShadow = false;
+				start = newStart;
+			}
+			else if (opaque && distance < radius)
+			{
+				// a wall starts here, the rows behind it are lit only up to its edge
+				inShadow = true;
+				castLight(view, distance + 1, start, leftSlope, xx, xy, yx, yy);
+				newStart = rightSlope;
+			}
+		}
+		if (inShadow) { break; }
+	}
+}
+
+void Visibility::computeFieldOfView(int x, int y, int radius, FieldOfView& view)
+{
+	sync();
+
+	if (radius < 0) { radius = 0; }
+	int side = radius * 2 + 1;
+	view.origin = { x, y };
+	view.radius = radius;
+	view.bits.assign(((size_t)side * side + 63) / 64, 0);
+	if (x < 0 || y < 0 || x >= m_width || y >= m_height) { return; }
+
+	markVisible(view, x, y);
+	for (int octant = 0; octant < 8; ++octant)
+	{
+		castLight(view, 1, 1.0f, 0.0f, OctantXX[octant], OctantXY[octant], OctantYX[octant], OctantYY[octant]);
+	}
+}
+
+size_t Visibility::update(const std::vector<Observer>& observers)
+{
+	sync();
+
+	size_t computed = 0;
+	for (const Observer& observer : observers)
+	{
+		CachedView* cached = nullptr;
+		auto it = m_viewIndex.find(key(observer.entity));
+		if (it == m_viewIndex.end())
+		{
+			m_viewIndex[key(observer.entity)] = m_views.size();
+			m_views.push_back(CachedView());
+			cached = &m_views.back();
+			cached->entity = observer.entity;
+		}
+		else
+		{
+			cached = &m_views[it->second];
+		}
+
+		int radius = observer.radius < 0 ? 0 : observer.radius;
+		if (cached->stale || cached->view.origin != observer.cell || cached->view.radius != radius)
+		{
+			computeFieldOfView(observer.cell.x, observer.cell.y, radius, cached->view);
+			cached->stale = false;
+			++computed;
+		}
+	}
+	m_viewsComputed += computed;
+	return computed;
+}
+
+const FieldOfView* Visibility::fieldOfView(EntityHandle observer) const
+{
+	auto it = m_viewIndex.find(key(observer));
+	return it == m_viewIndex.end() ? nullptr : &m_views[it->second].view;
+}
+
+bool Visibility::canSee(EntityHandle observer, int x, int y) const
+{
+	const FieldOfView* view = fieldOfView(observer);
+	return view && view->sees(x, y);
+}
+
+void Visibility::removeObserver(EntityHandle observer)
+{
+	auto it = m_viewIndex.find(key(observer));
+	if (it == m_viewIndex.end()) { return; }
+
+	// swap the last view into the removed one's place
+	size_t index = it->second;
+	m_viewIndex.erase(it);
+	if (index != m_views.size() - 1)
+	{
+		m_views[index] = std::move(m_views.back());
+		m_viewIndex[key(m_views[index].entity)] = index;
+	}
+	m_views.pop_back();
+}
+
+void Visibility::clear()
+{
+	m_views.clear();
+	m_viewIndex.clear();
+}
+
+size_t Visibility::observerCount() const
+{
+	return m_views.size();
+}
+
+size_t Visibility::viewsComputed() const
+{
+	return m_viewsComputed;
+}
\ No newline at end of file
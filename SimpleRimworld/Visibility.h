@@ -0,0 +1,96 @@
+#pragma once
+
+#include "TileGrid.h"
+
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+// The cells one observer can see, kept as a bit per cell of the square around it.
+struct FieldOfView
+{
+	GridCell              origin;
+	int                   radius = 0;
+	std::vector<uint64_t> bits;
+
+	bool sees(int x, int y) const;
+};
+
+// Line of sight and field of view over the blockVision cells of a TileGrid. Both only cost the cells
+// they pass over, however many entities are on the map.
+//
+// A line of sight walks the cells the line crosses and stops at the first one that blocks vision. The
+// cells at either end aren't checked, so a wall can be seen and an observer standing in a doorway isn't
+// blinded by it. A field of view is found with recursive shadowcasting: each of the eight octants around
+// the observer is scanned row by row outward, and every blocking cell met narrows the range of slopes the
+// rows behind it are scanned over.
+//
+// Fields of view are cached per observer entity. update() takes every observer each frame and only
+// recomputes the ones that moved, changed radius, or have a cell that started or stopped blocking vision
+// inside their radius. The changed cells come from the grid's vision log.
+class Visibility
+{
+public:
+
+	struct Observer
+	{
+		EntityHandle entity;
+		GridCell     cell;
+		int          radius = 0;
+	};
+
+private:
+
+	struct CachedView
+	{
+		EntityHandle entity;
+		FieldOfView  view;
+		bool         stale = true;
+	};
+
+	const TileGrid*                      m_grid = nullptr;
+	size_t                               m_gridVersion = 0;
+	int                                  m_width = 0;
+	int                                  m_height = 0;
+	std::vector<uint8_t>                 m_blocked;       // byte per cell copy of the grid's blockVision bits
+	std::vector<GridCell>                m_changes;
+
+	std::vector<CachedView>              m_views;
+	std::unordered_map<uint64_t, size_t> m_viewIndex;     // entity handle to its position in m_views
+
+	size_t                               m_viewsComputed = 0;
+
+	static uint64_t key(EntityHandle entity);
+	bool blocked(int x, int y) const;
+	void sync();
+	void rebuild();
+	void castLight(FieldOfView& view, int row, float start, float end, int xx, int xy, int yx, int yy) const;
+	static void markVisible(FieldOfView& view, int x, int y);
+
+public:
+
+	Visibility();
+	Visibility(const TileGrid& grid);
+
+	// Whether anything blocks vision on the cells strictly between two cells.
+	bool lineOfSight(int x0, int y0, int x1, int y1);
+
+	// The same between two world positions, walking every cell the segment passes through.
+	bool lineOfSight(const Vec2& from, const Vec2& to);
+
+	// Fills view with the cells that can be seen from a cell within radius cells. The cell itself is always seen.
+	void computeFieldOfView(int x, int y, int radius, FieldOfView& view);
+
+	// Brings the cached field of view of every observer given up to date. Returns how many were recomputed.
+	size_t update(const std::vector<Observer>& observers);
+
+	// The cached field of view of an observer, nullptr if it wasn't passed to update().
+	const FieldOfView* fieldOfView(EntityHandle observer) const;
+	bool canSee(EntityHandle observer, int x, int y) const;
+
+	void removeObserver(EntityHandle observer);
+	void clear();
+
+	size_t observerCount() const;
+	size_t viewsComputed() const;
+};
\ No newline at end of file
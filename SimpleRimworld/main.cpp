@@ -2,9 +2,70 @@
 #include <imgui-SFML.h>
 #include <SFML/Graphics.hpp>
 #include "GameEngine.h"
+#include "Benchmark.h"
 
-int main()
+#include <iostream>
+#include <string>
+#include <limits>
+#include <cstdlib>
+#include <cctype>
+#include <cerrno>
+
+int main(int argc, char* argv[])
 {
+	// SimpleRimworld --bench <name|all> runs the synthetic benchmarks in Benchmark.cpp and prints the results
+	if (argc > 1 && std::string(argv[1]) == "--bench")
+	{
+		if (argc != 3 || !Benchmark::run(argv[2]))
+		{
+			std::cerr << "Usage: " << argv[0] << " --bench <" << Benchmark::names() << "|all>" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// SimpleRimworld --headless <level file> <ticks> runs the game scene without a window and prints timings
+	if (argc > 1 && std::string(argv[1]) == "--headless")
+	{
+		// the tick count must be all digits: strtoull alone would skip junk after the number and wrap negative counts around
+		unsigned long long ticks = 0;
+		bool validTicks = false;
+		if (argc == 4 && std::isdigit((unsigned char)argv[3][0]))
+		{
+			char* end = nullptr;
+			errno = 0;
+			ticks = std::strtoull(argv[3], &end, 10);
+			validTicks = *end == '\0' && errno == 0 && ticks <= std::numeric_limits<size_t>::max();
+		}
+		if (!validTicks)
+		{
+			std::cerr << "Usage: " << argv[0] << " --headless <level file> <ticks>" << std::endl;
+			return 1;
+		}
+
+		GameEngine g("assets.txt", true);
+		g.runHeadless(argv[2], (size_t)ticks);
+		return 0;
+	}
+
+	// SimpleRimworld --replay <recording file> [--headless] plays a recording back as fast as it can and prints timings
+	if (argc > 1 && std::string(argv[1]) == "--replay")
+	{
+		bool headless = (argc == 4 && std::string(argv[3]) == "--headless");
+		if (argc != 3 && !headless)
+		{
+			std::cerr << "Usage: " << argv[0] << " --replay <recording file> [--headless]" << std::endl;
+			return 1;
+		}
+
+		GameEngine g("assets.txt", headless);
+		g.replay(argv[2]);
+		if (!headless) { g.run(); }
+		return 0;
+	}
+
+	// SimpleRimworld --record <recording file> plays as usual and records the input sent to the game scene
 	GameEngine g("assets.txt");
+	if (argc > 2 && std::string(argv[1]) == "--record") { g.recordInput(argv[2]); }
 	g.run();
 }
\ No newline at end of file